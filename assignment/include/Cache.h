@@ -0,0 +1,134 @@
+/**
+ * @file Cache.h
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief A cache on disk of what is known about the lengths of the simple accepting paths of each graph: the formula of several graphs is the conjunction of
+ *        independent formulas, one per graph, so a length is common to graphs if and only if each of them has a path of this length. The lengths proven
+ *        possible (with a path) or impossible for a graph are kept from a run to the next one, in a file named after a hash of the graph.
+ * @date 2019
+ */
+
+#ifndef COCA_CACHE_H_
+#define COCA_CACHE_H_
+
+#include <stdbool.h>
+#include <z3.h>
+#include "Graph.h"
+#include "Preprocessing.h"
+#include "Dynamic.h"
+
+/**
+ * @brief What is known about a length for a graph.
+ */
+typedef enum { LENGTH_UNKNOWN, LENGTH_FEASIBLE, LENGTH_INFEASIBLE } LengthStatus;
+
+/**
+ * @brief The lengths known for a graph, as read from the cache and completed during the run.
+ */
+typedef struct {
+	char *fileName;			///< The file of the graph in the cache.
+	int numNodes;			///< The number of nodes of the graph.
+	int numEdges;			///< The number of edges of the graph.
+	int numLengths;			///< The number of lengths a simple path can have in the graph (\ref maxPathLength + 1).
+	LengthStatus *status;	///< status[k] tells what is known about the length k.
+	int **witnesses;		///< For each length k proven feasible, a path of length k in the graph (its nodes), NULL for the other lengths.
+	int *rank;				///< rank[node] is the position of the name of node among the sorted names, which identifies it in the file.
+	bool modified;			///< true if something has been learnt since the file was read.
+} GraphCache;
+
+/**
+ * @brief Computes a hash of @p graph which does not depend on the order of its nodes and edges in its file: names, sources, targets and edges are hashed
+ *        following the order of the names.
+ * 
+ * @param graph A graph as read from its file (the lengths of the edges are not hashed).
+ * @param rank Filled with the position of the name of each node among the sorted names (NULL if not needed).
+ * @return unsigned long long The hash.
+ */
+unsigned long long hashGraph(Graph graph, int *rank);
+
+/**
+ * @brief Reads what the cache of @p directory knows about @p graph (nothing if it has no file for it, or if the file is not valid).
+ * 
+ * @param directory The directory of the cache.
+ * @param graph A graph, as read from its file.
+ * @return GraphCache The lengths known. Must be freed with \ref deleteGraphCache.
+ */
+GraphCache loadGraphCache(const char *directory, Graph graph);
+
+/**
+ * @brief Writes @p cache in its file if something has been learnt. The file is replaced at once, so that runs sharing the cache never read a partial file.
+ * 
+ * @param cache The lengths known for a graph.
+ */
+void saveGraphCache(GraphCache cache);
+
+/**
+ * @brief Frees the memory used by @p cache.
+ * 
+ * @param cache The lengths known for a graph.
+ */
+void deleteGraphCache(GraphCache cache);
+
+/**
+ * @brief Tells what is known about the length @p length.
+ * 
+ * @param cache The lengths known for a graph.
+ * @param length A length.
+ * @return LengthStatus LENGTH_INFEASIBLE if @p length is beyond \ref maxPathLength.
+ */
+LengthStatus getLengthStatus(GraphCache cache, int length);
+
+/**
+ * @brief Records that the graph of @p cache has the simple accepting path @p path of length @p length.
+ * 
+ * @param cache The lengths known for a graph.
+ * @param length The length of @p path.
+ * @param path The nodes of the path, in the graph given to \ref loadGraphCache. It is copied.
+ */
+void setLengthFeasible(GraphCache *cache, int length, int *path);
+
+/**
+ * @brief Records that the graph of @p cache has no simple accepting path of length @p length.
+ * 
+ * @param cache The lengths known for a graph.
+ * @param length The length.
+ */
+void setLengthInfeasible(GraphCache *cache, int length);
+
+/**
+ * @brief Decides if all graphs have a simple accepting path of length @p length graph by graph, since the formula of several graphs is the
+ *        conjunction of independent formulas: the lengths already known for a graph come from its cache, the other ones are computed (with
+ *        @p lengths), searched (with @p searchBudget) or solved for this graph alone, and recorded in its cache. The graphs are tried until one
+ *        has no path of this length.
+ * 
+ * @param ctx The context of the solver.
+ * @param reduced The graphs simplified by reduceGraph, given to the solver.
+ * @param caches The cache of each graph, loaded from the original graphs.
+ * @param lengths The lengths computed for each graph (see \ref computeDynamicLengths), NULL if none is computed.
+ * @param numGraphs The number of graphs.
+ * @param length The length.
+ * @param searchBudget The budget of findSimplePaths in each graph before calling the solver (0: never searched).
+ * @param paths Filled with the paths of length @p length in the original graphs if there are some (to free with deletePaths), NULL otherwise.
+ * @param numFoundInCache Increased if the length is decided by the caches alone.
+ * @return Z3_lbool Z3_L_TRUE if all graphs have such a path, Z3_L_FALSE if one of them has none, Z3_L_UNDEF if the solver cannot decide.
+ */
+Z3_lbool solveWithCache(Z3_context ctx, ReducedGraph *reduced, GraphCache *caches, PathLengths *lengths, unsigned int numGraphs, int length,
+						unsigned long searchBudget, int ***paths, unsigned int *numFoundInCache);
+
+/**
+ * @brief Finds the smallest common length with \ref solveWithCache, testing the possible lengths in increasing order.
+ * 
+ * @param ctx The context of the solver.
+ * @param reduced The graphs simplified by reduceGraph, given to the solver.
+ * @param caches The cache of each graph.
+ * @param lengths The lengths computed for each graph, NULL if none is computed.
+ * @param numGraphs The number of graphs.
+ * @param searchBudget The budget of findSimplePaths, as for \ref solveWithCache.
+ * @param length Filled with the smallest common length, if there is one.
+ * @param paths Filled as by \ref solveWithCache for @p length.
+ * @param numFoundInCache Increased by the number of lengths decided by the caches alone.
+ * @return Z3_lbool Z3_L_TRUE if there is a common length, Z3_L_FALSE if there is none, Z3_L_UNDEF if a length tested could not be decided.
+ */
+Z3_lbool findCachedLength(Z3_context ctx, ReducedGraph *reduced, GraphCache *caches, PathLengths *lengths, unsigned int numGraphs,
+						  unsigned long searchBudget, int *length, int ***paths, unsigned int *numFoundInCache);
+
+#endif
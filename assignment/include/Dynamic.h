@@ -0,0 +1,109 @@
+/**
+ * @file Dynamic.h
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief Computes at once all the lengths of the simple accepting paths of a small graph, by dynamic programming over the sets of nodes visited: the paths
+ *        from the source visiting the same nodes and ending at the same node can be extended the same way, so they are grouped in a state keeping the set
+ *        of their lengths. The states are built by increasing number of nodes visited, each one from the states with one node less, and a path of each
+ *        length found is rebuilt by going back through them. The number of states grows with the subsets of nodes, so this is only for small graphs,
+ *        whose lengths are then known without any formula.
+ * @date 2019
+ */
+
+#ifndef COCA_DYNAMIC_H_
+#define COCA_DYNAMIC_H_
+
+#include <stdbool.h>
+#include "Graph.h"
+#include "Preprocessing.h"
+
+#define MAX_DYNAMIC_NODES 64		///< The greatest number of nodes of a graph whose lengths can be computed: the sets of nodes are bits of an unsigned long long.
+#define MAX_DYNAMIC_STATES 4000000	///< The number of states after which \ref computePathLengths gives up (about 150 MB for the lengths up to 63).
+
+/**
+ * @brief The lengths of the simple accepting paths of a graph, as computed by \ref computePathLengths, with the states needed to rebuild a path of each length.
+ */
+typedef struct {
+	int numLengths;					///< The size of @p lengths: the upper bound of \ref lengthBounds + 1 (0 if the target is not reachable).
+	bool *lengths;					///< lengths[k] is true if the graph has a simple accepting path of length k. NULL if the lengths have not been computed.
+	int numWords;					///< The number of words of the set of lengths of a state.
+	unsigned long numStates;		///< The number of states built.
+	unsigned long long *visited;	///< visited[s] is the set of the nodes visited by the paths of the state s, the node i being the bit i.
+	int *last;						///< last[s] is the node the paths of the state s end at.
+	unsigned long long *reached;	///< The lengths of the paths of the state s are the bits set in reached[s*numWords] to reached[(s+1)*numWords-1].
+	unsigned long capacity;			///< The size of @p table, a power of 2.
+	unsigned long *table;			///< The hash table of the states: 0 for an empty slot, s+1 for the state s.
+} PathLengths;
+
+/**
+ * @brief Computes all the lengths of the simple accepting paths of @p graph. The paths are only extended through nodes from which the target can still be
+ *        reached without crossing the nodes they visited, and up to the upper bound of \ref lengthBounds.
+ * 
+ * @param graph A graph with a single source and a single target, of at most \ref MAX_DYNAMIC_NODES nodes (the lengths of its edges are taken into account).
+ * @param maxStates The greatest number of states built.
+ * @param lengths Filled with the lengths, to free with \ref deletePathLengths. Its field lengths is NULL if they could not be computed.
+ * @return bool false if @p graph has too many nodes or if more than @p maxStates states are needed: nothing is then known about its lengths.
+ */
+bool computePathLengths(Graph graph, unsigned long maxStates, PathLengths *lengths);
+
+/**
+ * @brief Rebuilds a simple accepting path of length @p pathLength of a graph from its states.
+ * 
+ * @param graph The graph given to \ref computePathLengths.
+ * @param lengths Its lengths.
+ * @param pathLength A length of lengths.lengths.
+ * @param path Filled with the path, of size @p pathLength + 1: path[pos] is the node at position pos (-1 if it is crossed by a longer edge), as by \ref findSimplePath.
+ * @return bool false if @p graph has no simple accepting path of length @p pathLength.
+ */
+bool getLengthWitness(Graph graph, PathLengths lengths, int pathLength, int *path);
+
+/**
+ * @brief Frees the memory used by the lengths of a graph.
+ * 
+ * @param lengths The lengths to delete (they may not have been computed).
+ */
+void deletePathLengths(PathLengths lengths);
+
+/**
+ * @brief Computes with \ref computePathLengths the lengths of the graphs of @p reduced of at most @p maxNodes nodes.
+ * 
+ * @param reduced An array of reduced graphs.
+ * @param numGraphs The number of graphs in @p reduced.
+ * @param maxNodes The greatest number of nodes of a graph whose lengths are computed.
+ * @param numComputed Increased by the number of graphs whose lengths have been computed.
+ * @return PathLengths* The lengths of each graph (their field lengths is NULL for the other graphs), to free with \ref deleteDynamicLengths.
+ *         NULL if the lengths of none of them could be computed.
+ */
+PathLengths *computeDynamicLengths(ReducedGraph *reduced, unsigned int numGraphs, int maxNodes, unsigned int *numComputed);
+
+/**
+ * @brief Removes from @p possible the lengths that one of the graphs whose lengths have been computed does not have.
+ * 
+ * @param possible possible[k] is true if the length k is possible, as given by possibleCommonLengths.
+ * @param maxLength The greatest length of @p possible.
+ * @param lengths The lengths of each graph, as given by \ref computeDynamicLengths (NULL if none is computed).
+ * @param numGraphs The number of graphs.
+ */
+void restrictToDynamicLengths(bool *possible, int maxLength, PathLengths *lengths, unsigned int numGraphs);
+
+/**
+ * @brief Gives the paths of length @p pathLength in all graphs from the ones found in the graphs whose lengths have not been computed,
+ *        the paths of the other graphs being rebuilt by \ref getLengthWitness.
+ * 
+ * @param reduced An array of reduced graphs.
+ * @param lengths Their lengths, as given by \ref computeDynamicLengths (NULL if none is computed).
+ * @param numGraphs The number of graphs in @p reduced.
+ * @param pathLength The length of the paths, one of those of the graphs whose lengths have been computed.
+ * @param found The paths found in the other graphs, in the same order (NULL if there is none), freed by this function.
+ * @return int** The paths in all the reduced graphs, to free with deletePaths.
+ */
+int **completePaths(ReducedGraph *reduced, PathLengths *lengths, unsigned int numGraphs, int pathLength, int **found);
+
+/**
+ * @brief Frees the lengths given by \ref computeDynamicLengths.
+ * 
+ * @param lengths The lengths of each graph (NULL does nothing).
+ * @param numGraphs The number of graphs.
+ */
+void deleteDynamicLengths(PathLengths *lengths, unsigned int numGraphs);
+
+#endif
@@ -16,18 +16,38 @@
 
 
 
-/** @brief: the graph type. The first four fields are needed to represent a directed graph. The rest depends on needs. Here, the rest represents initial and final states of an automaton.*/
+/** @brief: the graph type. The first seven fields are needed to represent a directed graph, the eighth one gives lengths to its edges. The rest depends on needs. Here, the rest represents initial and final states of an automaton.
+ *          Edges are stored as successor lists, so that the memory used is proportional to the number of edges and not to the square of the number of nodes.*/
 typedef struct {
 	int numNodes; ///< The number of nodes of the graph.
 	int numEdges; ///< The number of edges of the graph.
 	char** nodes; ///< The names of nodes of the graphs.
-	int* edges;	  ///< The edges of the graph.
+	int* successors;      ///< The successors of all nodes, sorted by node then by successor.
+	int* successorsIndex; ///< The successors of node i are successors[successorsIndex[i]] to successors[successorsIndex[i+1]-1].
+	int* predecessors;      ///< The predecessors of all nodes, sorted by node then by predecessor.
+	int* predecessorsIndex; ///< The predecessors of node i are predecessors[predecessorsIndex[i]] to predecessors[predecessorsIndex[i+1]-1].
+	int* weights;           ///< weights[j] is the length of the edge to successors[j]. NULL if all edges have length 1.
 
 //This is only for dealing with automata. May be changed according to needs.
 	bool *initial;	///< Array of source nodes.
 	bool *final;	///< Array of target nodes.
 } Graph;
 
+/**
+ * @brief Creates a graph. The names and the initial and final informations are copied, so the arguments can be freed after the call.
+ * 
+ * @param numNodes The number of nodes.
+ * @param names The names of the nodes.
+ * @param initial Tells for each node if it is a source.
+ * @param final Tells for each node if it is a target.
+ * @param numEdges The number of edges (counting duplicates).
+ * @param sources The sources of the edges.
+ * @param targets The targets of the edges: the i-th edge is (@p sources[i], @p targets[i]). Duplicated edges are kept only once.
+ * @param weights The lengths of the edges, or NULL if they all have length 1.
+ * @return Graph The graph created. Must be freed with deleteGraph.
+ */
+Graph makeGraph(int numNodes, char **names, bool *initial, bool *final, int numEdges, int *sources, int *targets, int *weights);
+
 /**
  * @brief Displays a graph with a list of nodes and a matrix of edges.
  * 
@@ -59,7 +79,7 @@ int orderG(Graph graph);
 int sizeG(Graph graph);
 
 /**
- * @brief Tells if (@p source, @p target) is an edge in @p graph.
+ * @brief Tells if (@p source, @p target) is an edge in @p graph. Takes a time logarithmic in the number of successors of @p source.
  * 
  * @param graph A graph.
  * @param source The source of the edge.
@@ -69,6 +89,80 @@ int sizeG(Graph graph);
  */
 bool isEdge(Graph graph, int source, int target);
 
+/**
+ * @brief Returns the number of successors of @p node in @p graph.
+ * 
+ * @param graph A graph.
+ * @param node A node.
+ * @return int The number of nodes n such that (@p node, n) is an edge in @p graph.
+ */
+int numSuccessors(Graph graph, int node);
+
+/**
+ * @brief Returns the successors of @p node in @p graph, by increasing identifier. Allows to visit the edges in time proportional to their number.
+ * 
+ * @param graph A graph.
+ * @param node A node.
+ * @return int* An array of numSuccessors(@p graph, @p node) nodes. Owned by the graph, must not be freed.
+ */
+int* getSuccessors(Graph graph, int node);
+
+/**
+ * @brief Returns the index of @p target in the successors of @p source, in time logarithmic in their number.
+ * 
+ * @param graph A graph.
+ * @param source A node.
+ * @param target A node.
+ * @return int The index i such that getSuccessors(@p graph, @p source)[i] is @p target, -1 if (@p source, @p target) is not an edge.
+ */
+int findSuccessor(Graph graph, int source, int target);
+
+/**
+ * @brief Returns the length of the edge from @p node to its successor number @p index.
+ * 
+ * @param graph A graph.
+ * @param node A node.
+ * @param index The index of the successor in getSuccessors(@p graph, @p node).
+ * @return int The length of the edge (1 if the edges of @p graph have no length).
+ */
+int successorWeight(Graph graph, int node, int index);
+
+/**
+ * @brief Returns the length of the edge (@p source, @p target).
+ * 
+ * @param graph A graph.
+ * @param source The source of the edge.
+ * @param target The target of the edge.
+ * @return int The length of the edge, 0 if it is not an edge.
+ */
+int edgeWeight(Graph graph, int source, int target);
+
+/**
+ * @brief Returns an upper bound on the length of the simple paths of @p graph: its number of nodes minus one, plus what edges longer than one add.
+ * 
+ * @param graph A graph.
+ * @return int The bound.
+ */
+int maxPathLength(Graph graph);
+
+/**
+ * @brief Returns the number of predecessors of @p node in @p graph.
+ * 
+ * @param graph A graph.
+ * @param node A node.
+ * @return int The number of nodes n such that (n, @p node) is an edge in @p graph.
+ */
+int numPredecessors(Graph graph, int node);
+
+/**
+ * @brief Returns the predecessors of @p node in @p graph, by increasing identifier.
+ * 
+ * @param graph A graph.
+ * @param node A node.
+ * @return int* An array of numPredecessors(@p graph, @p node) nodes. Owned by the graph, must not be freed.
+ */
+int* getPredecessors(Graph graph, int node);
+
 /**
  * @brief Tells if @p node is source in @p graph.
  * 
@@ -25,5 +25,15 @@
  */
 Graph getGraphFromFile(char *toRead);
 
+/**
+ * @brief Parses several files at the same time with @p numThreads threads (each file has its own scanner), as \ref getGraphFromFile would do one by one.
+ * 
+ * @param fileNames The names of files in graphviz format.
+ * @param numFiles The number of files in @p fileNames.
+ * @param numThreads The number of threads reading the files (one file at a time each, no thread is created if it is 1).
+ * @param graphs Filled with the graphs read, in the order of @p fileNames.
+ */
+void getGraphsFromFiles(char **fileNames, int numFiles, int numThreads, Graph *graphs);
+
 
 #endif
\ No newline at end of file
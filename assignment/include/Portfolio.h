@@ -0,0 +1,30 @@
+/**
+ * @file Portfolio.h
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief Races several engines on the same graphs: no engine is the fastest on every instance, so the program is run once per engine, each run
+ *        with its own options, and the first definitive answer is kept.
+ * @date 2019
+ */
+
+#ifndef COCA_PORTFOLIO_H_
+#define COCA_PORTFOLIO_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Runs the program once per engine, each one with the options of @p argv followed by -x and the options of its engine, and displays the
+ *        answer of the first one to give a definitive answer, as told by its exit status (\ref EXIT_FOUND or \ref EXIT_NOT_FOUND), the others being
+ *        stopped then. The engines which fail or cannot decide (\ref EXIT_UNDECIDED) are waited for until one decides; if none does, the first
+ *        undecided answer is displayed.
+ * 
+ * @param argc The number of arguments of the program.
+ * @param argv The arguments of the program, without those of -R.
+ * @param engines The options of each engine, separated by spaces.
+ * @param numEngines The number of engines.
+ * @param printStats true to display which engine answered.
+ * @param answerStatus true to return the exit status of the engine displayed, as with -x.
+ * @return int EXIT_FAILURE if no engine answered, and otherwise the exit status of the engine displayed with @p answerStatus, EXIT_SUCCESS without.
+ */
+int racePortfolio(int argc, char **argv, char **engines, int numEngines, bool printStats, bool answerStatus);
+
+#endif
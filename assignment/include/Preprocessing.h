@@ -0,0 +1,131 @@
+/**
+ * @file Preprocessing.h
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief Simplifications of the graphs applied between their parsing and the solver. They remove the nodes and edges which cannot belong to a simple accepting path,
+ *        so that every formula is smaller, and keep the correspondence with the original graphs so that results are displayed with them.
+ * @date 2019
+ */
+
+#ifndef COCA_PREPROCESSING_H_
+#define COCA_PREPROCESSING_H_
+
+#include "Graph.h"
+
+/**
+ * @brief A graph simplified by \ref reduceGraph, and the correspondence between its nodes and the ones of the graph it comes from.
+ */
+typedef struct {
+	Graph graph;		///< The simplified graph, which has the same simple accepting paths as the original one.
+	int *originalNode;	///< originalNode[i] is the identifier in the original graph of the node i of @p graph.
+	int *chainStart;	///< For the j-th edge of @p graph (in the order of its successor lists), the nodes of the original graph it replaces are chainNodes[chainStart[j]] to chainNodes[chainStart[j]+w-2], w being its length. NULL if @p graph has no weights.
+	int *chainNodes;	///< The original nodes of the contracted chains. NULL if @p graph has no weights.
+} ReducedGraph;
+
+/**
+ * @brief Simplifies @p graph without changing its simple accepting paths: removes self-loops, edges going to the source or leaving the target, and nodes which are
+ *        not reachable from the source or from which the target is not reachable. The source and the target are always kept. Node names are kept.
+ * 
+ * @param graph A graph with a single source and a single target.
+ * @return ReducedGraph The simplified graph. Must be freed with \ref deleteReducedGraph.
+ */
+ReducedGraph reduceGraph(Graph graph);
+
+/**
+ * @brief Contracts the chains of @p reduced: a node other than the source and the target with exactly one predecessor and one successor is always
+ *        crossed the same way, so each maximal chain of such nodes is replaced by a single edge whose length is the number of edges it replaces.
+ *        Chains closing a cycle are removed, and a chain is cut before its last node when the contracted edge would duplicate another one.
+ * 
+ * @param reduced A graph given by \ref reduceGraph.
+ * @return ReducedGraph The contracted graph. Its original nodes are the ones of the graph @p reduced comes from. Must be freed with \ref deleteReducedGraph.
+ */
+ReducedGraph contractChains(ReducedGraph reduced);
+
+/**
+ * @brief Computes the length of the shortest paths from @p start to every node (or from every node to @p start), taking the lengths of the edges into account.
+ * 
+ * @param graph A graph.
+ * @param start The node the paths start from (or end at).
+ * @param forward true for the paths starting from @p start, false for the ones ending at @p start.
+ * @param distance Filled with the length of the shortest path for each node, -1 if there is none.
+ */
+void shortestDistances(Graph graph, int start, bool forward, int *distance);
+
+/**
+ * @brief Computes the strongly connected components of @p graph with Tarjan's algorithm (without recursion).
+ * 
+ * @param graph A graph.
+ * @param component Filled with the number of the component of each node. Components are numbered in reverse topological order:
+ *        an edge between two components goes to the one with the smaller number.
+ * @return int The number of components.
+ */
+int stronglyConnectedComponents(Graph graph, int *component);
+
+/**
+ * @brief Bounds the length of the simple accepting paths of @p graph. The lower bound is the length of the shortest path from the source to the target.
+ *        The upper bound follows the strongly connected components: a simple path crosses them in topological order and uses at most one outgoing edge
+ *        of each of their nodes, so it is the longest path in the graph of the components, each one weighing the sum of the longest outgoing edges of its nodes.
+ * 
+ * @param graph A graph with a single source and a single target.
+ * @param lower Filled with the lower bound, -1 if the target is not reachable.
+ * @param upper Filled with the upper bound (at most \ref maxPathLength), -1 if the target is not reachable.
+ */
+void lengthBounds(Graph graph, int *lower, int *upper);
+
+/**
+ * @brief Computes the period of the lengths of the accepting walks of @p graph (and so of its simple accepting paths): with d(u) the distance from the source to u,
+ *        each edge (u,v) of length w shifts the length of a walk by d(u)+w-d(v) compared to d(v)-d(u), so all walks from the source to the target have the length
+ *        d(target) modulo the gcd of these shifts, over the edges between nodes reachable from the source and reaching the target.
+ * 
+ * @param graph A graph with a single source and a single target.
+ * @param period Filled with the gcd, 0 if every accepting walk has the length @p residue.
+ * @param residue Filled with the length of the accepting walks modulo @p period (between 0 and @p period - 1), -1 if the target is not reachable.
+ */
+void lengthPeriod(Graph graph, int *period, int *residue);
+
+/**
+ * @brief Finds the nodes through which every accepting path of @p graph goes: the dominators of the target, computed with the iterative algorithm of
+ *        Cooper, Harvey and Kennedy. They are also the post-dominators of the source, and every accepting path meets them in the same order.
+ * 
+ * @param graph A graph with a single source and a single target.
+ * @param nodes Filled with the mandatory nodes other than the source and the target, in the order of the paths (at most orderG(graph) - 2 of them).
+ * @return int The number of nodes written in @p nodes (0 if the target is not reachable).
+ */
+int mandatoryNodes(Graph graph, int *nodes);
+
+/**
+ * @brief Frees the memory used by a reduced graph (but not by the graph it comes from).
+ * 
+ * @param reduced The reduced graph to delete.
+ */
+void deleteReducedGraph(ReducedGraph reduced);
+
+/**
+ * @brief Replaces, in each path of @p paths, the nodes of the reduced graphs by the corresponding nodes of the original graphs,
+ *        and fills the positions crossed by contracted edges (-1 in @p paths) with the nodes of their chains.
+ * 
+ * @param reduced An array of reduced graphs.
+ * @param numGraphs The number of graphs in @p reduced.
+ * @param pathLength The length of the paths.
+ * @param paths The paths in the reduced graphs (as given by getPathsFromModel), modified in place.
+ */
+void liftPaths(ReducedGraph *reduced, int numGraphs, int pathLength, int **paths);
+
+/**
+ * @brief Removes the nodes and edges of @p graph that cannot be in a simple accepting path (\ref reduceGraph), and replaces its chains of nodes
+ *        by longer edges (\ref contractChains), before building any formula.
+ * 
+ * @param graph A graph with a single source and a single target.
+ * @return ReducedGraph The simplified graph. Must be freed with \ref deleteReducedGraph.
+ */
+ReducedGraph simplifyGraph(Graph graph);
+
+/**
+ * @brief Gives the graphs of @p reduced in an array, as expected by the functions building formulas.
+ * 
+ * @param reduced An array of reduced graphs.
+ * @param numGraphs The number of graphs in @p reduced.
+ * @return Graph* An array of @p numGraphs graphs, to free (but not the graphs themselves).
+ */
+Graph *getReducedGraphs(ReducedGraph *reduced, unsigned int numGraphs);
+
+#endif
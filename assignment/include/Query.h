@@ -0,0 +1,109 @@
+/**
+ * @file Query.h
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief Answers a query: decides if some graphs have a simple accepting path of a common length, and displays the answer and the paths found.
+ *        The way the lengths are decided (one formula per length, a single formula, the search, the dynamic programming or the cache) and what is
+ *        displayed depend on the options of the query, which are given to each function instead of being read from global variables, so that
+ *        queries with different options can be answered by the same program.
+ * @date 2019
+ */
+
+#ifndef COCA_QUERY_H_
+#define COCA_QUERY_H_
+
+#include <stdbool.h>
+#include <z3.h>
+#include "Graph.h"
+#include "Preprocessing.h"
+#include "Dynamic.h"
+#include "Cache.h"
+#include "Selection.h"
+
+#define EXIT_FOUND 0		///< With -x, the exit status when a common length is found.
+#define EXIT_NOT_FOUND 2	///< With -x, the exit status when no common length exists.
+#define EXIT_UNDECIDED 3	///< With -x, the exit status when the solver could not decide (EXIT_FAILURE and the other statuses being kept for the errors).
+
+/**
+ * @brief The options of a query, as given on the command line.
+ */
+typedef struct {
+	bool printPath;				///< With -t, the paths found are displayed on the terminal.
+	bool writeDotFile;			///< With -f, the paths found are written in dot files.
+	char *dotFileName;			///< With -o, the prefix of the dot files (NULL: "sol/result").
+	bool printFormula;			///< With -F, the formulas solved are displayed.
+	bool separately;			///< With -s, the lengths are tested one by one, each one being answered.
+	bool testAll;				///< With -a, all lengths are answered, not only up to the first one found.
+	bool decreasingOrder;		///< With -d, the lengths are tested in decreasing order.
+	bool longest;				///< With -M, the longest common length is found by findExtremeLength.
+	bool shortest;				///< With -m, the shortest common length is found by findExtremeLength.
+	bool sharedFormula;			///< With -u, the formula shared by all lengths (graphsToSharedFormula) is solved instead of graphsToFullFormula.
+	bool lazySimplicity;		///< With -l, each length is solved with solvePathLazily instead of the whole formula of the encoding.
+	unsigned long searchBudget;	///< With -H, the number of nodes expanded by findSimplePaths in each graph before calling the solver for a length (0: never).
+	bool seedPhases;			///< With -P, the solver starts from the paths found by findSimplePaths or for the previous length.
+	int dynamicNodes;			///< With -B, the graphs of at most this number of nodes once simplified have their lengths computed (0: none).
+	bool *lengths;				///< With -r, lengths[k] is true if the length k is asked (NULL: all lengths).
+	int numLengths;				///< The size of @p lengths.
+	char *lengthsSpec;			///< The argument of -r, for the messages.
+	char *cacheDirectory;		///< With -C, the directory of the cache of the lengths of each graph (NULL: no cache).
+	unsigned int solverTimeout;	///< With -T, the milliseconds given to each check of the solver (0: no limit).
+	unsigned int timeLimit;		///< With -L, the milliseconds after which the solver is not called anymore (0: no limit).
+	bool automaticEngine;		///< With -A or -c, the engine is chosen for each query by \ref selectQueryEngine.
+	CostModel costModel;		///< The cost model of the engine selection, read with -c.
+} QueryOptions;
+
+/**
+ * @brief The graphs of a query, with what is known about them.
+ */
+typedef struct {
+	Graph *graphs;				///< The graphs, as read from their files.
+	ReducedGraph *reduced;		///< The graphs simplified by simplifyGraph, given to the solver.
+	unsigned int numGraphs;		///< The number of graphs.
+	GraphCache *caches;			///< The lengths known for each graph, with -C (NULL otherwise).
+	PathLengths *lengths;		///< The lengths computed for each graph, with -B (see \ref computeDynamicLengths), NULL if none is computed.
+} Query;
+
+/**
+ * @brief What has been done to answer the queries, displayed with -S.
+ */
+typedef struct {
+	unsigned int foundBySearch;	///< The number of lengths for which findSimplePaths found the paths without the solver.
+	unsigned int foundInCache;	///< The number of lengths decided by the cache alone.
+	unsigned int dynamicGraphs;	///< The number of graphs whose lengths have been computed by dynamic programming.
+	unsigned int unresolved;	///< The number of lengths left undecided with -s.
+	Engine engine;				///< The engine chosen by the last \ref selectQueryEngine.
+	GraphFeatures features;		///< The features of the graphs of the last \ref selectQueryEngine.
+} QueryStatistics;
+
+/**
+ * @brief Returns the options of a query when no option is given.
+ * 
+ * @return QueryOptions The options.
+ */
+QueryOptions defaultQueryOptions(void);
+
+/**
+ * @brief Chooses the engine deciding the lengths of the graphs of @p query with the cost model of @p options, and adapts the options accordingly:
+ *        the search gets an unlimited budget, the dynamic programming is tried on all graphs, and the other engines keep the options of -H and -B.
+ * 
+ * @param options The options of the query.
+ * @param query The graphs of the query.
+ * @param verbose true to display the engine chosen and the cost estimated for each engine.
+ * @param statistics Filled with the engine chosen and the features of the graphs.
+ * @return QueryOptions The options to answer the query with.
+ */
+QueryOptions selectQueryEngine(QueryOptions options, Query query, bool verbose, QueryStatistics *statistics);
+
+/**
+ * @brief Decides if the graphs of @p query have a simple accepting path of a common length, and displays the answer: with -s, a line per length
+ *        tested, and otherwise OUI, NON or UNKNOWN (or the length found with -M, -m or -r). The paths found are displayed and/or written in dot files
+ *        according to the options.
+ * 
+ * @param ctx The context of the solver.
+ * @param options The options of the query.
+ * @param query The graphs of the query. Their caches learn the lengths decided.
+ * @param statistics Increased by what has been done to answer.
+ * @return Z3_lbool Z3_L_TRUE if a common length has been found, Z3_L_FALSE if there is none (among the lengths asked), Z3_L_UNDEF if it is undecided.
+ */
+Z3_lbool answerQuery(Z3_context ctx, QueryOptions options, Query query, QueryStatistics *statistics);
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file Search.h
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief Searches for simple accepting paths directly in the graphs, without the solver. They are tried before building formulas: on most positive instances,
+ *        they find paths of the length asked much faster than the solver, and the solver is only called when they fail.
+ * @date 2019
+ */
+
+#ifndef COCA_SEARCH_H_
+#define COCA_SEARCH_H_
+
+#include <stdbool.h>
+#include <limits.h>
+#include "Graph.h"
+
+#define UNLIMITED_BUDGET ULONG_MAX	///< A budget the search never exhausts: it then fails only if there is no path, or if the deadline of setSolverDeadline is passed.
+
+/**
+ * @brief Looks for a simple accepting path of length @p pathLength in @p graph by a depth-first search from the source. A branch is cut as soon as the
+ *        target cannot be reached with the length left, and the search gives up after expanding @p budget nodes or once the deadline of setSolverDeadline
+ *        is passed, so a failure does not mean there is no path (unless @p budget is \ref UNLIMITED_BUDGET and the deadline is not passed).
+ * 
+ * @param graph A graph with a single source and a single target (the lengths of its edges are taken into account).
+ * @param pathLength The length of the path.
+ * @param budget The greatest number of nodes expanded.
+ * @param path Filled with the path found, of size @p pathLength + 1: path[pos] is the node at position pos (-1 if it is crossed by a longer edge).
+ * @return true if a path has been found, false if there is none or if the budget is exhausted.
+ */
+bool findSimplePath(Graph graph, int pathLength, unsigned long budget, int *path);
+
+/**
+ * @brief Looks for a simple accepting path of length @p pathLength in @p graph by meeting in the middle: the partial paths followed backward from the target
+ *        are enumerated until their length reaches the half of @p pathLength (rounded up), and indexed by the node they stop at, their length, and the set of
+ *        their nodes. A depth-first search from the source up to the half (rounded down) then looks, at each node, for a backward half starting there with the
+ *        length left and sharing no other node. On both sides, the partial paths with the same last node, length and set of nodes are followed once.
+ *        Each side only goes half as deep as \ref findSimplePath, but the partial paths followed are all kept in memory.
+ * 
+ * @param graph A graph with a single source and a single target (the lengths of its edges are taken into account: a backward half stops at the first
+ *        node at which it reaches the half, so that each path is split once).
+ * @param pathLength The length of the path.
+ * @param budget The greatest number of partial paths followed, by both sides: a failure does not mean there is no path (unless @p budget is \ref UNLIMITED_BUDGET
+ *        and the deadline of setSolverDeadline, which also stops the search, is not passed).
+ * @param path Filled with the path found, as by \ref findSimplePath.
+ * @return true if a path has been found, false if there is none or if the budget is exhausted.
+ */
+bool findMeetingPath(Graph graph, int pathLength, unsigned long budget, int *path);
+
+/**
+ * @brief Looks for a simple accepting path of length @p pathLength in @p graph by the depth-first search of \ref findSimplePath, shared by @p numThreads threads
+ *        so that a single large graph uses all processors. The subtrees of the search are tasks, given by the branch leading to them: each thread has a queue of
+ *        tasks, and when another thread is idle, it gives to its queue the successors not tried yet of the shallowest node of its branch. An idle thread takes
+ *        the last task of its queue, or else steals the first task of another one, and all threads stop as soon as one of them finds a path.
+ * 
+ * @param graph A graph with a single source and a single target (the lengths of its edges are taken into account).
+ * @param pathLength The length of the path.
+ * @param budget The greatest number of nodes expanded, by all threads (they may expand a few thousands more before noticing it, or the deadline of
+ *        setSolverDeadline).
+ * @param numThreads The number of threads.
+ * @param path Filled with the path found, as by \ref findSimplePath (which path is found depends on the threads).
+ * @return true if a path has been found, false if there is none or if the budget is exhausted.
+ */
+bool findParallelPath(Graph graph, int pathLength, unsigned long budget, int numThreads, int *path);
+
+/**
+ * @brief Chooses how \ref findSimplePaths searches each graph: with \ref findSimplePath (the default), or with \ref findMeetingPath.
+ * 
+ * @param bidirectional true for \ref findMeetingPath.
+ */
+void setBidirectionalSearch(bool bidirectional);
+
+/**
+ * @brief Chooses the number of threads with which \ref findSimplePaths searches each graph, with \ref findParallelPath if it is more than 1
+ *        (unless \ref findMeetingPath is chosen).
+ * 
+ * @param numThreads The number of threads (1 by default).
+ */
+void setSearchThreads(int numThreads);
+
+/**
+ * @brief Looks for a simple accepting path of length @p pathLength in each graph of @p graphs with \ref findSimplePath (or \ref findMeetingPath or \ref findParallelPath, see \ref setBidirectionalSearch and \ref setSearchThreads).
+ * 
+ * @param graphs An array of graphs.
+ * @param numGraphs The number of graphs in @p graphs.
+ * @param pathLength The length of the paths.
+ * @param budget The greatest number of nodes expanded in each graph.
+ * @param partial false to give up as soon as the search fails in a graph, true to go on with the other graphs (the paths found are then hints, see \ref getPathHints).
+ * @return int** The paths found, as given by getPathsFromModel (to free with deletePaths). If @p partial is false, NULL if the search failed for one of the graphs,
+ *         otherwise paths[i] is NULL for each graph i in which the search failed.
+ */
+int **findSimplePaths(Graph *graphs, int numGraphs, int pathLength, unsigned long budget, bool partial);
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ * @file Selection.h
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief Chooses the engine deciding the common lengths of some graphs from cheap features of the graphs and a cost model: the cost of each engine is
+ *        estimated in seconds, as a sum of the quantities it depends on, each one weighed by a coefficient of the model (the estimate of the nodes
+ *        searched, a coarse upper bound, is raised to a power first).
+ *        To calibrate the model on a set of instances, run each engine on them with -S: the features and the time displayed give, for each engine,
+ *        the seconds per unit of its quantities (for instance the time of the solver divided by the number of variables), to write in a model file.
+ * @date 2019
+ */
+
+#ifndef COCA_SELECTION_H_
+#define COCA_SELECTION_H_
+
+#include <stdbool.h>
+#include "Graph.h"
+
+/**
+ * @brief The engines which can decide the common lengths.
+ */
+typedef enum {
+	ENGINE_SOLVER,	///< The formulas of the encoding chosen, given to the solver for each length.
+	ENGINE_SEARCH,	///< The depth-first search of \ref findSimplePath for each length, without budget.
+	ENGINE_DYNAMIC,	///< The lengths of each graph computed at once by \ref computePathLengths (the graphs needing too many states go to the solver).
+	NUM_ENGINE_KINDS
+} Engine;
+
+/**
+ * @brief The features of a set of graphs used to estimate the cost of the engines.
+ */
+typedef struct {
+	int numGraphs;			///< The number of graphs.
+	int numNodes;			///< The number of nodes of the largest graph.
+	int numEdges;			///< The number of edges of the graph with the most edges.
+	double density;			///< The greatest density of a graph: its number of edges divided by numNodes * (numNodes - 1).
+	double branching;		///< The greatest average number of successors of a node in a graph.
+	int largestComponent;	///< The number of nodes of the largest strongly connected component of a graph.
+	int minLength;			///< The smallest common length possible (-1 if there is none).
+	int maxLength;			///< The greatest common length possible (-1 if there is none).
+	int numLengths;			///< The number of common lengths possible (see \ref possibleCommonLengths).
+	double variables;		///< The number of variables of the formulas of all lengths possible, in all graphs, once pruned (see \ref countPathVariables).
+	double expansions;		///< An estimate of the number of nodes expanded by the search for all lengths possible, in all graphs.
+	double subsets;			///< The number of sets of nodes of the graphs, 2^numNodes summed over the graphs, which bounds the states of the dynamic programming.
+} GraphFeatures;
+
+/**
+ * @brief The coefficients of the cost model, in seconds.
+ */
+typedef struct {
+	double solverPerVariable;	///< Time of the solver per variable of the formulas.
+	double solverPerLength;		///< Time to build a formula and start the solver, per length.
+	double searchPerNode;		///< Time of the search per node expanded, the nodes being counted as expansions^searchExponent.
+	double searchExponent;		///< The estimate of GraphFeatures::expansions being a coarse upper bound, the search grows like a power of it.
+	double searchPerLength;		///< Time to start the search, per length.
+	double dynamicPerState;		///< Time of the dynamic programming per state, the states being counted as subsets^dynamicExponent.
+	double dynamicExponent;		///< Most sets of nodes are not visited by a simple accepting path, so the states grow like a power of GraphFeatures::subsets.
+} CostModel;
+
+/**
+ * @brief Computes the features of @p graphs.
+ * 
+ * @param graphs An array of graphs, with a single source and a single target each (as given by reduceGraph).
+ * @param numGraphs The number of graphs in @p graphs.
+ * @return GraphFeatures The features.
+ */
+GraphFeatures computeFeatures(Graph *graphs, int numGraphs);
+
+/**
+ * @brief Returns the cost model calibrated on the instances given with the project.
+ * 
+ * @return CostModel The model.
+ */
+CostModel defaultCostModel(void);
+
+/**
+ * @brief Reads the coefficients of a cost model in a file, each line being "NAME VALUE" where NAME is solver_per_variable, solver_per_length,
+ *        search_per_node, search_exponent, search_per_length, dynamic_per_state or dynamic_exponent (the lines starting with # are ignored). Exits the program if the file cannot be read or is malformed.
+ * 
+ * @param fileName The name of the file.
+ * @param model The model whose coefficients are replaced by the ones of the file.
+ * @return CostModel The model read.
+ */
+CostModel readCostModel(const char *fileName, CostModel model);
+
+/**
+ * @brief Estimates the time @p engine takes to decide all common lengths possible of graphs having the features @p features. The dynamic programming
+ *        giving up after \ref MAX_DYNAMIC_STATES states, it costs that much more than the solver when it is expected to need more.
+ * 
+ * @param model The cost model.
+ * @param features The features of the graphs.
+ * @param engine The engine.
+ * @return double The time estimated, in seconds.
+ */
+double estimateCost(CostModel model, GraphFeatures features, Engine engine);
+
+/**
+ * @brief Chooses the engine with the smallest estimated cost.
+ * 
+ * @param model The cost model.
+ * @param features The features of the graphs.
+ * @return Engine The engine chosen.
+ */
+Engine chooseEngine(CostModel model, GraphFeatures features);
+
+/**
+ * @brief Computes the features of @p graphs and chooses the engine with the smallest estimated cost (\ref chooseEngine).
+ * 
+ * @param model The cost model.
+ * @param graphs An array of graphs, as for \ref computeFeatures.
+ * @param numGraphs The number of graphs in @p graphs.
+ * @param verbose true to display the engine chosen and the cost estimated for each engine.
+ * @param features Filled with the features of @p graphs.
+ * @return Engine The engine chosen.
+ */
+Engine selectEngine(CostModel model, Graph *graphs, int numGraphs, bool verbose, GraphFeatures *features);
+
+/**
+ * @brief Returns the name of an engine, as displayed.
+ * 
+ * @param engine The engine.
+ * @return const char* Its name.
+ */
+const char *getEngineName(Engine engine);
+
+#endif
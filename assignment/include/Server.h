@@ -0,0 +1,66 @@
+/**
+ * @file Server.h
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief Answers the queries read on the standard input, keeping the graphs loaded from one query to the next: a program asking many queries on
+ *        the same graphs pays for the parsing, the simplification, the caches and the dynamic programming of each graph only once. The context
+ *        of the solver is shared by all queries, but a new solver is built for each check, as without the server.
+ * @date 2019
+ */
+
+#ifndef COCA_SERVER_H_
+#define COCA_SERVER_H_
+
+#include <stdbool.h>
+#include <time.h>
+#include <z3.h>
+#include "Graph.h"
+#include "Preprocessing.h"
+#include "Dynamic.h"
+#include "Cache.h"
+#include "Query.h"
+
+#define MAX_QUERY_SIZE 4096		///< The longest query line read by \ref serve.
+
+/**
+ * @brief A graph kept loaded by \ref serve from one query to the next, with what is computed from it.
+ */
+typedef struct {
+	char *fileName;			///< The file of the graph, as named in the queries.
+	time_t modified;		///< The last modification of the file when it was read, to read it again if it changes.
+	Graph graph;			///< The graph.
+	ReducedGraph reduced;	///< The graph simplified by simplifyGraph.
+	GraphCache cache;		///< The lengths known for the graph, with -C.
+	PathLengths lengths;	///< The lengths computed for the graph, with -B (see computePathLengths).
+	bool lengthsTried;		///< true once the lengths have been computed, or found too costly to compute.
+} LoadedGraph;
+
+/**
+ * @brief Answers the queries read on the standard input until the line "quit" or its end. Each query is a line "COMMAND FILE...": "first" looks
+ *        for the smallest common length of the graphs of the files (as -s), "all" for all common lengths (as -s -a), and "witness" for the smallest
+ *        one with its paths (as -s -t). Each answer ends with a line "END".
+ *        The graphs, their caches with -C and their lengths with -B, stay loaded between the queries and are read again only if their file changes.
+ * 
+ * @param ctx The context of the solver, shared by all queries.
+ * @param options The options of all queries, copied for each one with the options of its command.
+ * @param printStats true to display the calls to the solver and the time of each query.
+ * @param loadingThreads The number of threads parsing the files.
+ * @param fileNames The files to load before the first query.
+ * @param numFiles The number of files in @p fileNames.
+ */
+void serve(Z3_context ctx, QueryOptions options, bool printStats, int loadingThreads, char **fileNames, int numFiles);
+
+/**
+ * @brief Finds the graphs of the files @p names among @p loaded, reading (in parallel) those that are not loaded or whose file changed.
+ * 
+ * @param loaded The graphs loaded, extended with the new ones.
+ * @param numLoaded The number of graphs in @p loaded.
+ * @param names The files of the graphs.
+ * @param numNames The number of files in @p names.
+ * @param indices Filled with the index in @p loaded of the graph of each file.
+ * @param cacheDirectory The directory of the caches of the graphs (NULL: no cache).
+ * @param loadingThreads The number of threads parsing the files.
+ * @return bool false, after answering the error, if a file does not exist.
+ */
+bool loadQueryGraphs(LoadedGraph **loaded, int *numLoaded, char **names, int numNames, int *indices, char *cacheDirectory, int loadingThreads);
+
+#endif
@@ -14,6 +14,7 @@
 #define COCA_SOLVING_H_
 
 #include "Graph.h"
+#include <stdio.h>
 #include <z3.h>
 
 /**
@@ -22,12 +23,59 @@
  * @param ctx The solver context.
  * @param number The number of the graph.
  * @param position The position in the path.
- * @param k The mysterious k from the subject of this assignment.
+ * @param k The mysterious k from the subject of this assignment (-1 in the formula shared by all lengths, see \ref graphsToSharedFormula).
  * @param node The node identifier.
  * @return Z3_ast The formula.
  */
 Z3_ast getNodeVariable(Z3_context ctx, int number, int position, int k, int node);
 
+/**
+ * @brief A way to encode in a formula that a graph has a simple accepting path of a given length. The encoding used by \ref graphsToPathFormula (and so by
+ *        \ref graphsToFullFormula) is chosen at runtime with \ref setPathEncoding, and the paths of a model are decoded whatever the encoding it comes from.
+ */
+typedef struct {
+	const char *name;			///< The name of the encoding, as given on the command line.
+	const char *description;	///< A one line description of the encoding.
+	Z3_ast (*makeFormula)(Z3_context ctx, Graph graph, int number, int pathLength); ///< Builds the formula for the graph number @p number and the length @p pathLength.
+} PathEncoding;
+
+/**
+ * @brief Returns the number of encodings available.
+ * 
+ * @return int The number of encodings.
+ */
+int numPathEncodings(void);
+
+/**
+ * @brief Returns an encoding available.
+ * 
+ * @param index The index of the encoding, lower than \ref numPathEncodings. The encoding of index 0 is the default one.
+ * @return const PathEncoding* The encoding.
+ */
+const PathEncoding *getPathEncoding(int index);
+
+/**
+ * @brief Finds an encoding from its name.
+ * 
+ * @param name The name of the encoding.
+ * @return const PathEncoding* The encoding, NULL if no encoding has this name.
+ */
+const PathEncoding *findPathEncoding(const char *name);
+
+/**
+ * @brief Chooses the encoding used by the next calls to \ref graphsToPathFormula.
+ * 
+ * @param encoding The encoding, given by \ref getPathEncoding or \ref findPathEncoding.
+ */
+void setPathEncoding(const PathEncoding *encoding);
+
+/**
+ * @brief Returns the encoding used by \ref graphsToPathFormula.
+ * 
+ * @return const PathEncoding* The encoding.
+ */
+const PathEncoding *getCurrentPathEncoding(void);
+
 /**
  * @brief Generates a SAT formula satisfiable if and only if all graphs of @p graphs contain an accepting path of length @p pathLength.
  * 
@@ -49,6 +97,120 @@ Z3_ast graphsToPathFormula( Z3_context ctx, Graph *graphs,unsigned int numGraphs
  */
 Z3_ast graphsToFullFormula( Z3_context ctx, Graph *graphs,unsigned int numGraphs);
 
+/**
+ * @brief Generates a SAT formula satisfiable if and only if all graphs of @p graphs contain an accepting path of common length, whose size is about the one
+ *        of a formula for a single length: the variables of the paths do not depend on the length, which is chosen by a one-hot selector shared by all graphs
+ *        (the target of each graph is at position k if and only if the length k is selected), and an "ended" marker forbids any node after the chosen length.
+ *        A node is used at most once thanks to a "used before" variable per position, so the formula is linear in the number of pairs (node, position).
+ *        Unlike \ref graphsToFullFormula, the length found is any common length, not necessarily the smallest one.
+ * 
+ * @param ctx The solver context.
+ * @param graphs An array of graphs.
+ * @param numGraphs The number of graphs in @p graphs.
+ * @return Z3_ast The formula.
+ */
+Z3_ast graphsToSharedFormula( Z3_context ctx, Graph *graphs,unsigned int numGraphs);
+
+/**
+ * @brief Generates the formula of \ref graphsToSharedFormula, restricted to the lengths allowed by @p lengths: the selector of the length must pick one of them,
+ *        and the paths are only encoded up to the greatest one. A single solve then answers whether some allowed length is common to all graphs.
+ * 
+ * @param ctx The solver context.
+ * @param graphs An array of graphs.
+ * @param numGraphs The number of graphs in @p graphs.
+ * @param lengths lengths[k] is true if the length k is allowed (NULL: all lengths are allowed).
+ * @param numLengths The size of @p lengths: the lengths from @p numLengths on are not allowed.
+ * @return Z3_ast The formula.
+ */
+Z3_ast graphsToLengthsFormula( Z3_context ctx, Graph *graphs,unsigned int numGraphs, const bool *lengths, int numLengths);
+
+/**
+ * @brief Computes the window of lengths a simple accepting path can have in all graphs of @p graphs: the intersection of the bounds given by \ref lengthBounds.
+ * 
+ * @param graphs An array of graphs.
+ * @param numGraphs The number of graphs in @p graphs.
+ * @param low Filled with the smallest length of the window.
+ * @param high Filled with the greatest length of the window (smaller than @p low if it is empty).
+ * @return bool false if the window is empty: the graphs have no common length.
+ */
+bool commonLengthBounds(Graph *graphs, unsigned int numGraphs, int *low, int *high);
+
+/**
+ * @brief Tells which lengths a simple accepting path can have in all graphs of @p graphs: the ones of the window of \ref commonLengthBounds which have,
+ *        for each graph, the residue of its accepting walks modulo their period (see \ref lengthPeriod). Only these lengths need a formula.
+ * 
+ * @param graphs An array of graphs.
+ * @param numGraphs The number of graphs in @p graphs.
+ * @param maxLength Filled with \ref maxCommonLength.
+ * @return bool* An array of size @p maxLength + 1, true for the possible lengths (to free).
+ */
+bool *possibleCommonLengths(Graph *graphs, unsigned int numGraphs, int *maxLength);
+
+/**
+ * @brief Counts the variables "node at position" of the formula of the paths of length @p pathLength in @p graph, once the nodes which cannot be at a position are removed.
+ * 
+ * @param graph A graph.
+ * @param pathLength The length of the paths.
+ * @return int The number of pairs of a position and a node which can be at this position.
+ */
+int countPathVariables(Graph graph, int pathLength);
+
+/**
+ * @brief Returns the greatest length a simple accepting path can have in all graphs of @p graphs (see \ref commonLengthBounds).
+ * 
+ * @param graphs An array of graphs.
+ * @param numGraphs The number of graphs in @p graphs.
+ * @return int The smallest upper bound among the ones of the graphs, 0 if there is no common length.
+ */
+int maxCommonLength(Graph *graphs, unsigned int numGraphs);
+
+/**
+ * @brief Finds the longest (or the shortest) length such that all graphs of @p graphs contain a simple accepting path of this length, without testing the lengths
+ *        one by one: the formula of \ref graphsToSharedFormula is given once to an incremental solver, and a dichotomy bounds the selected length with assumptions.
+ *        Each model found gives a length which may be far beyond the bound assumed, so only a few checks are needed.
+ * 
+ * @param ctx The solver context.
+ * @param graphs An array of graphs.
+ * @param numGraphs The number of graphs in @p graphs.
+ * @param lengths The lengths allowed, as in \ref graphsToLengthsFormula (NULL: all lengths are allowed).
+ * @param numLengths The size of @p lengths.
+ * @param longest true for the longest length, false for the shortest one.
+ * @param model Filled with a model describing paths of the length found (to free with Z3_model_dec_ref), 0 if there is none.
+ * @param proven Set to false if a check could not be decided in the time given (see \ref setSolverTimeout): the length found may then not be the extreme
+ *        one, and -1 only means that no length was found.
+ * @return int The length found, -1 if the graphs have no common length.
+ */
+int findExtremeLength(Z3_context ctx, Graph *graphs, unsigned int numGraphs, const bool *lengths, int numLengths, bool longest, Z3_model *model, bool *proven);
+
+/**
+ * @brief Decides whether all graphs of @p graphs contain a simple accepting path of length @p pathLength with the variables of the onehot encoding,
+ *        adding the simplicity constraints lazily: the solver first looks for walks (one node per position), and each node repeated in the walks found
+ *        is then asked to be used at most once before solving again in the same solver. Most walks repeat few nodes, so few constraints are added.
+ * 
+ * @param ctx The solver context.
+ * @param graphs An array of graphs.
+ * @param numGraphs The number of graphs in @p graphs.
+ * @param pathLength The length of the paths.
+ * @param model Filled with a model describing simple paths of length @p pathLength (to free with Z3_model_dec_ref), 0 if there is none.
+ * @return Z3_lbool Z3_L_TRUE if there are such paths, Z3_L_FALSE if there are none and Z3_L_UNDEF if the solver cannot decide.
+ */
+Z3_lbool solvePathLazily(Z3_context ctx, Graph *graphs, unsigned int numGraphs, int pathLength, Z3_model *model);
+
+/**
+ * @brief Gives the variables of the onehot encoding (\ref getNodeVariable) which would be true for paths of length @p pathLength close to @p path, to be given
+ *        as hints to \ref solveFormulaWithHints. The nodes of @p path are kept at their positions, except the target when it is not at the end.
+ * 
+ * @param ctx The solver context.
+ * @param graph A graph.
+ * @param number The number of @p graph in the formula.
+ * @param pathLength The length of the paths of the formula.
+ * @param path A path in @p graph (as given by \ref getPathsFromModel), whose length may differ from @p pathLength.
+ * @param hintLength The length of @p path.
+ * @param hints Filled with the variables, at most min(@p pathLength, @p hintLength)+1 of them.
+ * @return unsigned int The number of variables written in @p hints.
+ */
+unsigned int getPathHints(Z3_context ctx, Graph graph, int number, int pathLength, int *path, int hintLength, Z3_ast *hints);
+
 /**
  * @brief Gets the length of the solution from a given model.
  * 
@@ -59,6 +221,61 @@ Z3_ast graphsToFullFormula( Z3_context ctx, Graph *graphs,unsigned int numGraphs
  */ 
 int getSolutionLengthFromModel(Z3_context ctx, Z3_model model, Graph *graphs);
 
+/**
+ * @brief Decodes the paths of length @p pathLength of each graph in @p graphs described by @p model. The model is walked only once: the constants it interprets as true
+ *        are matched against the names built by \ref getNodeVariable, so no variable has to be rebuilt nor evaluated.
+ * 
+ * @param ctx The solver context.
+ * @param model A variable assignment.
+ * @param graphs An array of graphs.
+ * @param numGraph The number of graphs in @p graphs.
+ * @param pathLength The length of path.
+ * @return int** An array of @p numGraph arrays of size @p pathLength + 1 such that paths[i][pos] is the node at position pos in the path of graph i (-1 if there is none).
+ *         Must be freed with \ref deletePaths.
+ */
+int **getPathsFromModel(Z3_context ctx, Z3_model model, Graph *graphs, int numGraph, int pathLength);
+
+/**
+ * @brief Frees the paths returned by \ref getPathsFromModel.
+ * 
+ * @param paths The paths to free.
+ * @param numGraph The number of graphs the paths were decoded for.
+ */
+void deletePaths(int **paths, int numGraph);
+
+/**
+ * @brief Displays the paths of length @p pathLength of each graphs in @p graphs.
+ * 
+ * @param graphs An array of graphs.
+ * @param numGraph The number of graphs in @p graphs.
+ * @param pathLength The length of path.
+ * @param paths The paths as decoded by \ref getPathsFromModel (the positions -1, crossed by a longer edge, are skipped).
+ */
+void printPaths(Graph *graphs, int numGraph, int pathLength, int **paths);
+
+/**
+ * @brief Writes in @p fd the graphs of @p graphs in dot format, with the paths @p paths of length @p pathLength colored. Each node and edge is visited once.
+ * 
+ * @param fd The stream to write in.
+ * @param graphs An array of graphs.
+ * @param numGraph The number of graphs in @p graphs.
+ * @param pathLength The length of path.
+ * @param paths The paths as decoded by \ref getPathsFromModel (the positions -1, crossed by a longer edge, are skipped).
+ */
+void writeDotFromPaths(FILE *fd, Graph *graphs, int numGraph, int pathLength, int **paths);
+
+/**
+ * @brief Creates the file ("%s-l%d.dot",name,pathLength) representing the paths @p paths of length @p pathLength in each graph of @p graphs, or ("result-l%d.dot,pathLength")
+ *        if name is NULL. If @p name is "-", the result is written on the standard output.
+ * 
+ * @param graphs An array of graphs.
+ * @param numGraph The number of graphs in @p graphs.
+ * @param pathLength The length of path.
+ * @param paths The paths as decoded by \ref getPathsFromModel.
+ * @param name The name of the output file (may contain a directory).
+ */
+void createDotFromPaths(Graph *graphs, int numGraph, int pathLength, int **paths, char *name);
+
 /**
  * @brief Displays the paths of length @p pathLength of each graphs in @p graphs described by @p model.
  * 
@@ -72,6 +289,7 @@ void printPathsFromModel(Z3_context ctx, Z3_model model, Graph *graphs, int numG
 
 /**
  * @brief Creates the file ("%s-l%d.dot",name,pathLength) representing the solution to the problem described by @p model, or ("result-l%d.dot,pathLength") if name is NULL.
+ *        If @p name is "-", the result is written on the standard output.
  * 
  * @param ctx The solver context.
  * @param model A variable assignment.
@@ -14,6 +14,7 @@
 #ifndef COCA_Z3TOOLS_H_
 #define COCA_Z3TOOLS_H_
 
+#include <stdbool.h>
 #include <z3.h>
 
 /**
@@ -33,6 +34,97 @@ Z3_context makeContext(void);
  */
 Z3_ast mk_bool_var(Z3_context ctx, const char * name);
 
+/**
+ * @brief Creates a formula containing a single integer variable whose name is given in parameter. As with \ref mk_bool_var, each call with the same name
+ *        produces the same variable.
+ * 
+ * @param ctx The context of the solver.
+ * @param name The name the variable.
+ * @return Z3_ast The formula consisting in the variable.
+ */
+Z3_ast mk_int_var(Z3_context ctx, const char * name);
+
+/**
+ * @brief Creates a formula containing a single bit-vector variable of @p size bits whose name is given in parameter. As with \ref mk_bool_var, each call
+ *        with the same name produces the same variable.
+ * 
+ * @param ctx The context of the solver.
+ * @param name The name the variable.
+ * @param size The number of bits of the variable.
+ * @return Z3_ast The formula consisting in the variable.
+ */
+Z3_ast mk_bv_var(Z3_context ctx, const char * name, unsigned int size);
+
+/**
+ * @brief Returns the number of times the solver has been called (by \ref isFormulaSat, \ref solveFormula, \ref solveFormulaWithHints, \ref checkWithAssumption or \ref getModelFromSatFormula) since the beginning of the program.
+ * 
+ * @return unsigned int The number of calls.
+ */
+unsigned int getNumSolverCalls(void);
+
+/**
+ * @brief Chooses the solver built by \ref makeSolver, and so used by all functions of this file. The parameters given before with \ref addSolverParam
+ *        are kept, and checked against the parameters of the new kind.
+ * 
+ * @param ctx The context of the solver, in which the tactics are looked for.
+ * @param kind "default" for the general solver of Z3 (Z3_mk_solver), "simple" for a solver without preprocessing (Z3_mk_simple_solver),
+ *        or names of tactics separated by commas, applied one after the other (such as "simplify,tseitin-cnf,sat").
+ * @return bool false if @p kind names an unknown tactic, or if its solver has no parameter given before (or one of another type), in which case the solver is not changed.
+ */
+bool setSolverKind(Z3_context ctx, const char *kind);
+
+/**
+ * @brief Returns the kind of solver given to \ref setSolverKind.
+ * 
+ * @return const char* The kind of solver, "default" if none was given.
+ */
+const char *getSolverKind(void);
+
+/**
+ * @brief Adds a parameter given to each solver built by \ref makeSolver, such as "random_seed=3", "restart=luby" or "threads=4".
+ * 
+ * @param ctx The context of the solver.
+ * @param setting The parameter, as "NAME=VALUE".
+ * @return bool false if the solver chosen has no such parameter or if the value does not fit its type, in which case it is not added.
+ */
+bool addSolverParam(Z3_context ctx, const char *setting);
+
+/**
+ * @brief Builds a solver of the kind chosen with \ref setSolverKind, with the parameters given to \ref addSolverParam.
+ * 
+ * @param ctx The context of the solver.
+ * @return Z3_solver The solver, already referenced: to free with Z3_solver_dec_ref.
+ */
+Z3_solver makeSolver(Z3_context ctx);
+
+/**
+ * @brief Limits the time of each check done by the functions of this file. A check which takes longer stops and gives Z3_L_UNDEF.
+ * 
+ * @param milliseconds The time given to each check, 0 for no limit.
+ */
+void setSolverTimeout(unsigned int milliseconds);
+
+/**
+ * @brief Returns the time given to each check by \ref setSolverTimeout.
+ * 
+ * @return unsigned int The time in milliseconds, 0 if there is no limit.
+ */
+unsigned int getSolverTimeout(void);
+
+/**
+ * @brief Sets a moment after which no check is done anymore: the checks are shortened to end before it, and the later ones give Z3_L_UNDEF at once.
+ * 
+ * @param milliseconds The time left from now, 0 for no deadline.
+ */
+void setSolverDeadline(unsigned int milliseconds);
+
+/**
+ * @brief Tells if the moment given to \ref setSolverDeadline is passed.
+ * 
+ * @return bool true if it is passed, false if it is not or if there is no deadline.
+ */
+bool isDeadlinePassed(void);
+
 /**
  * @brief Tells if a formula is satisfiable, unsatisfiable, or cannot be decided.
  * 
@@ -43,6 +135,44 @@ Z3_ast mk_bool_var(Z3_context ctx, const char * name);
  */
 Z3_lbool isFormulaSat(Z3_context ctx, Z3_ast formula);
 
+/**
+ * @brief Tells if a formula is satisfiable and, if so, gives an assignment of variables satisfying it. Unlike calling \ref isFormulaSat then \ref getModelFromSatFormula,
+ *        the solver is only called once. The model obtained must be freed with Z3_model_dec_ref.
+ * 
+ * @param ctx The context of the solver.
+ * @param formula The formula to check.
+ * @param model Filled with an assignment of variables satisfying @p formula if it is satisfiable, NULL otherwise.
+ * @return Z3_lbool Same as \ref isFormulaSat.
+ */
+Z3_lbool solveFormula(Z3_context ctx, Z3_ast formula, Z3_model *model);
+
+/**
+ * @brief Same as \ref solveFormula, but the search starts near an expected assignment: the literals of @p hints are first assumed, and when they contradict
+ *        the formula, the ones of the unsatisfiable core are dropped and the others assumed again, a few times before solving without them.
+ *        The answer does not depend on the hints, only the time to find it.
+ * 
+ * @param ctx The context of the solver.
+ * @param formula The formula to check.
+ * @param hints Literals (variables or their negations) probably true in a model of @p formula. The array is modified.
+ * @param numHints The number of literals in @p hints.
+ * @param model Same as in \ref solveFormula.
+ * @return Z3_lbool Same as \ref isFormulaSat.
+ */
+Z3_lbool solveFormulaWithHints(Z3_context ctx, Z3_ast formula, Z3_ast *hints, unsigned int numHints, Z3_model *model);
+
+/**
+ * @brief Checks the formulas asserted in an incremental solver, under an assumption which does not stay in the solver, and gives an assignment of
+ *        variables satisfying them if they are satisfiable. What the solver learns is kept for the next checks.
+ * 
+ * @param ctx The context of the solver.
+ * @param solver The solver, in which the formulas have been asserted with Z3_solver_assert.
+ * @param assumption A formula assumed for this check only (a variable or its negation), NULL for none.
+ * @param model Filled with the assignment found if the formulas are satisfiable (to free with Z3_model_dec_ref), 0 otherwise.
+ * @return Z3_lbool Z3_L_FALSE if the formulas are unsatisfiable under @p assumption, Z3_L_TRUE if they are satisfiable and Z3_L_UNDEF if the solver cannot decide.
+ */
+Z3_lbool checkWithAssumption(Z3_context ctx, Z3_solver solver, Z3_ast assumption, Z3_model *model);
+
+
 /**
  * @brief Returns an assignment of variables satisfying the formula if it is satisfiable. Exits the program if the formula is unsatisfiable.
  * 
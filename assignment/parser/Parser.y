@@ -29,6 +29,7 @@ int yyerror(GraphList *expression, yyscan_t scanner, const char *msg) {
 %code requires {
   typedef void* yyscan_t;
   enum stateType {None,Init,Final,InitFinal};
+  #define MAX_NAME_SIZE 1024 /* size of the buffer in which the scanner copies the names it reads (its extra data) */
 }
 
 %output  "Parser.c"
@@ -19,11 +19,22 @@ int findNode(char **list,int size,char *target){
 	return -1;
 }
 
-Graph createGraph(GraphList source){
-	Graph res;
+/*
+ * @brief A node name and its index, to find indexes of names by binary search.
+ */
+typedef struct {
+	char *name;
+	int index;
+} NamedNode;
 
-	res.numNodes=0;
-	res.numEdges=0;
+/*
+ * @brief Compares two NamedNode by name, for qsort and bsearch.
+ */
+static int compareNamedNodes(const void *a, const void *b){
+	return strcmp(((const NamedNode *)a)->name,((const NamedNode *)b)->name);
+}
+
+Graph createGraph(GraphList source){
 	SNodeList *explore = source.nodes;
 
 	int count = 0;
@@ -31,51 +42,65 @@ Graph createGraph(GraphList source){
 		count++;
 		explore = explore->next;
 	}
-	res.numNodes=count;
+	int numNodes=count;
 
 	//printf("nodes: %d\n",count);
 
-	res.edges = (int *)malloc(res.numNodes*res.numNodes*sizeof(int));
-	res.nodes = (char **)malloc(res.numNodes*sizeof(char*));
+	char **names = (char **)malloc((numNodes+1)*sizeof(char*));
+	NamedNode *sorted = (NamedNode *)malloc((numNodes+1)*sizeof(NamedNode));
 
 	//Ajout pour les automates.
-	res.initial = (bool *)malloc(res.numNodes*sizeof(bool));
-	res.final = (bool *)malloc(res.numNodes*sizeof(bool));
+	bool *initial = (bool *)malloc((numNodes+1)*sizeof(bool));
+	bool *final = (bool *)malloc((numNodes+1)*sizeof(bool));
 
 	count=0;
 	explore = source.nodes;
 	while(explore != NULL){
-		res.nodes[count] = (char *)malloc((strlen(explore->node)+1)*sizeof(char));
-		strcpy(res.nodes[count],explore->node);
+		names[count] = explore->node;
+		sorted[count].name = explore->node;
+		sorted[count].index = count;
 
 		//Pour les automates.
-		res.initial[count] = explore->initial;
-		res.final[count] = explore->final;
+		initial[count] = explore->initial;
+		final[count] = explore->final;
 
 		count++;
 		explore = explore->next;
 	}
 
-	/*for(int i = 0; i<res.numNodes;i++){
-		printf("%s,",res.nodes[i]);
-	}
-	printf("\n");
-	*/
-
-	for(int i = 0; i<res.numNodes;i++)
-		for(int j = 0; j<res.numNodes;j++)
-			res.edges[i*res.numNodes+j] = 0;
-
+	//Names are sorted so that each edge end is found in logarithmic time.
+	qsort(sorted,numNodes,sizeof(NamedNode),compareNamedNodes);
 
+	int numEdges = 0;
 	SEdgeList *exploreBis = source.edges;
 	while(exploreBis != NULL){
-		int n1,n2;
-		n1=findNode(res.nodes,res.numNodes,exploreBis->node1);
-		n2=findNode(res.nodes,res.numNodes,exploreBis->node2);
-		res.edges[n1*res.numNodes+n2] = 1;
+		numEdges++;
 		exploreBis = exploreBis->next;
-		res.numEdges++;
 	}
+	int *sources = (int *)malloc((numEdges+1)*sizeof(int));
+	int *targets = (int *)malloc((numEdges+1)*sizeof(int));
 
+	count = 0;
+	exploreBis = source.edges;
+	while(exploreBis != NULL){
+		NamedNode key, *n1, *n2;
+		key.name = exploreBis->node1;
+		n1 = (NamedNode *)bsearch(&key,sorted,numNodes,sizeof(NamedNode),compareNamedNodes);
+		key.name = exploreBis->node2;
+		n2 = (NamedNode *)bsearch(&key,sorted,numNodes,sizeof(NamedNode),compareNamedNodes);
+		sources[count] = n1->index;
+		targets[count] = n2->index;
+		count++;
+		exploreBis = exploreBis->next;
+	}
+
+	Graph res = makeGraph(numNodes,names,initial,final,numEdges,sources,targets,NULL);
+
+	free(names);
+	free(sorted);
+	free(initial);
+	free(final);
+	free(sources);
+	free(targets);
 	return res;
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@
 #include "Parser.h"
 #include "Lexer.h"
 #include "GraphListToGraph.h"
+#include <pthread.h>
 
 int yyparse(GraphList *expression, yyscan_t scanner);
  
@@ -17,11 +18,12 @@ GraphList getGraphList(const char *expr)
     GraphList expression;
     yyscan_t scanner;
     YY_BUFFER_STATE state;
+    char name[MAX_NAME_SIZE]; /* the scanner copies the names it reads here, so that each call has its own buffer */
 
     expression.nodes=NULL;
     expression.edges=NULL;
  
-    if (yylex_init(&scanner)) {
+    if (yylex_init_extra(name, &scanner)) {
         /* could not initialize */
         printf("Error initialization\n");
         return expression;
@@ -53,11 +55,12 @@ GraphList getGraphListFromFile(FILE *toRead)
     GraphList expression;
     yyscan_t scanner;
     YY_BUFFER_STATE state;
+    char name[MAX_NAME_SIZE]; /* the scanner copies the names it reads here, so that each call has its own buffer */
 
     expression.nodes=NULL;
     expression.edges=NULL;
  
-    if (yylex_init(&scanner)) {
+    if (yylex_init_extra(name, &scanner)) {
         /* could not initialize */
         printf("Error initialization\n");
         return expression;
@@ -93,3 +96,62 @@ Graph getGraphFromFile(char *toRead){
     deleteNodeList(e.nodes);
     return graph;
 }
+
+/**
+ * @brief The files shared by the threads of \ref getGraphsFromFiles: each thread parses the next file not taken yet.
+ */
+typedef struct {
+    char **fileNames;       ///< The names of the files.
+    Graph *graphs;          ///< The graphs read, in the order of @p fileNames.
+    int numFiles;           ///< The number of files.
+    int next;               ///< The index of the next file to parse.
+    pthread_mutex_t lock;   ///< Protects @p next.
+} LoadingQueue;
+
+/**
+ * @brief Parses the files of a \ref LoadingQueue until there is none left.
+ * 
+ * @param queue The LoadingQueue.
+ * @return void* NULL.
+ */
+void *loadGraphs(void *queue)
+{
+    LoadingQueue *files = (LoadingQueue *)queue;
+    while (true) {
+        pthread_mutex_lock(&files->lock);
+        int index = files->next++;
+        pthread_mutex_unlock(&files->lock);
+        if (index >= files->numFiles)
+            return NULL;
+        files->graphs[index] = getGraphFromFile(files->fileNames[index]);
+    }
+}
+
+void getGraphsFromFiles(char **fileNames, int numFiles, int numThreads, Graph *graphs)
+{
+    if (numThreads > numFiles)
+        numThreads = numFiles;
+    if (numThreads <= 1) {
+        for (int i = 0; i < numFiles; i++)
+            graphs[i] = getGraphFromFile(fileNames[i]);
+        return;
+    }
+
+    LoadingQueue queue;
+    queue.fileNames = fileNames;
+    queue.graphs = graphs;
+    queue.numFiles = numFiles;
+    queue.next = 0;
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_t *threads = (pthread_t *)malloc(numThreads*sizeof(pthread_t));
+    for (int i = 0; i < numThreads; i++) {
+        if (pthread_create(&threads[i], NULL, loadGraphs, &queue) != 0) {
+            fprintf(stderr, "Could not create a thread to read the graphs.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < numThreads; i++)
+        pthread_join(threads[i], NULL);
+    free(threads);
+    pthread_mutex_destroy(&queue.lock);
+}
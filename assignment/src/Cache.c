@@ -0,0 +1,335 @@
+/**
+ * @file Cache.c
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief An implementation of \ref Cache.h function's
+ * @date 2019
+ */
+
+
+#include "Cache.h"
+#include "Search.h"
+#include "Solving.h"
+#include "Z3Tools.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define CACHE_HEADER		"equalPath-cache 1"	// first line of the files of the cache
+#define FNV_OFFSET			14695981039346656037ULL
+#define FNV_PRIME			1099511628211ULL
+
+/**
+* @brief hashBytes adds @p size bytes to a FNV-1a hash
+* @param hash the hash so far
+* @param bytes the bytes to add
+* @param size the number of bytes
+* @return the new hash
+*/
+static unsigned long long hashBytes(unsigned long long hash, const void *bytes, size_t size);
+
+/**
+* @brief compareInts compares two integers, for qsort
+* @param a the first integer
+* @param b the second integer
+* @return a negative number, zero or a positive number if the first integer is smaller, equal or greater
+*/
+static int compareInts(const void *a, const void *b);
+
+/**
+* @brief compareNodeNames compares the names of two nodes of \ref sortedGraph, for qsort
+* @param a the first node
+* @param b the second node
+* @return the comparison of their names by strcmp
+*/
+static int compareNodeNames(const void *a, const void *b);
+
+static Graph sortedGraph; // the graph whose nodes are sorted by \ref compareNodeNames (qsort has no parameter for it)
+
+
+static unsigned long long hashBytes(unsigned long long hash, const void *bytes, size_t size)
+{
+	for(size_t i=0; i<size; i++)
+	{
+		hash ^= ((const unsigned char *)bytes)[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+static int compareInts(const void *a, const void *b)
+{
+	return *(const int *)a - *(const int *)b;
+}
+
+static int compareNodeNames(const void *a, const void *b)
+{
+	return strcmp(getNodeName(sortedGraph, *(const int *)a), getNodeName(sortedGraph, *(const int *)b));
+}
+
+unsigned long long hashGraph(Graph graph, int *rank)
+{
+	int order = orderG(graph);
+	int *byName = (int *)malloc((order+1)*sizeof(int));
+	int *ranks = (int *)malloc((order+1)*sizeof(int));
+	int *successors = (int *)malloc((order+1)*sizeof(int));
+	for(int node=0; node<order; node++)
+		byName[node] = node;
+	sortedGraph = graph;
+	qsort(byName, order, sizeof(int), compareNodeNames);
+	for(int i=0; i<order; i++)
+		ranks[byName[i]] = i;
+
+	unsigned long long hash = hashBytes(FNV_OFFSET, &order, sizeof(int));
+	for(int i=0; i<order; i++)
+	{
+		int node = byName[i];
+		char *name = getNodeName(graph, node);
+		bool ends[2] = {isSource(graph, node), isTarget(graph, node)};
+		hash = hashBytes(hash, name, strlen(name)+1);
+		hash = hashBytes(hash, ends, sizeof(ends));
+
+		/* the successors are hashed by rank, so the ranks are sorted */
+		int numSucc = numSuccessors(graph, node);
+		for(int j=0; j<numSucc; j++)
+			successors[j] = ranks[getSuccessors(graph, node)[j]];
+		qsort(successors, numSucc, sizeof(int), compareInts);
+		hash = hashBytes(hash, &numSucc, sizeof(int));
+		hash = hashBytes(hash, successors, numSucc*sizeof(int));
+	}
+	if(rank != NULL)
+		memcpy(rank, ranks, order*sizeof(int));
+	free(byName);
+	free(ranks);
+	free(successors);
+	return hash;
+}
+
+GraphCache loadGraphCache(const char *directory, Graph graph)
+{
+	GraphCache cache;
+	cache.numNodes = orderG(graph);
+	cache.numEdges = sizeG(graph);
+	cache.numLengths = maxPathLength(graph) + 1;
+	cache.status = (LengthStatus *)malloc(cache.numLengths*sizeof(LengthStatus));
+	cache.witnesses = (int **)malloc(cache.numLengths*sizeof(int *));
+	for(int k=0; k<cache.numLengths; k++)
+	{
+		cache.status[k] = LENGTH_UNKNOWN;
+		cache.witnesses[k] = NULL;
+	}
+	cache.rank = (int *)malloc((cache.numNodes+1)*sizeof(int));
+	unsigned long long hash = hashGraph(graph, cache.rank);
+	cache.fileName = (char *)malloc(strlen(directory) + 32);
+	sprintf(cache.fileName, "%s/%016llx.txt", directory, hash);
+	cache.modified = false;
+
+	/* the file holds the header, the number of nodes and edges (against collisions), then a line per length known: its status and its path */
+	FILE *file = fopen(cache.fileName, "r");
+	if(file == NULL)
+		return cache;
+	char header[64];
+	int numNodes, numEdges;
+	if(fgets(header, sizeof(header), file) == NULL || strncmp(header, CACHE_HEADER, strlen(CACHE_HEADER)) != 0
+		|| fscanf(file, "%d %d", &numNodes, &numEdges) != 2 || numNodes != cache.numNodes || numEdges != cache.numEdges)
+	{
+		fclose(file);
+		return cache;
+	}
+	int *byRank = (int *)malloc((cache.numNodes+1)*sizeof(int));
+	for(int node=0; node<cache.numNodes; node++)
+		byRank[cache.rank[node]] = node;
+	int length, feasible;
+	while(fscanf(file, "%d %d", &length, &feasible) == 2 && length >= 0 && length < cache.numLengths)
+	{
+		if(!feasible)
+		{
+			cache.status[length] = LENGTH_INFEASIBLE;
+			continue;
+		}
+		int *path = (int *)malloc((length+1)*sizeof(int));
+		bool valid = true;
+		for(int pos=0; pos<=length && valid; pos++)
+		{
+			int rank;
+			valid = fscanf(file, "%d", &rank) == 1 && rank >= 0 && rank < cache.numNodes;
+			if(valid)
+				path[pos] = byRank[rank];
+		}
+		if(!valid)
+		{
+			free(path);
+			break;
+		}
+		free(cache.witnesses[length]);
+		cache.status[length] = LENGTH_FEASIBLE;
+		cache.witnesses[length] = path;
+	}
+	free(byRank);
+	fclose(file);
+	return cache;
+}
+
+void saveGraphCache(GraphCache cache)
+{
+	if(!cache.modified)
+		return;
+	char *directory = (char *)malloc(strlen(cache.fileName)+1);
+	strcpy(directory, cache.fileName);
+	*strrchr(directory, '/') = '\0';
+	mkdir(directory, 0755);
+	free(directory);
+
+	/* written in a file of its own, then renamed over the previous one */
+	char *temporary = (char *)malloc(strlen(cache.fileName) + 32);
+	sprintf(temporary, "%s.%ld", cache.fileName, (long)getpid());
+	FILE *file = fopen(temporary, "w");
+	if(file == NULL)
+	{
+		fprintf(stderr, "Cannot write the cache file %s\n", temporary);
+		free(temporary);
+		return;
+	}
+	fprintf(file, "%s\n", CACHE_HEADER);
+	fprintf(file, "%d %d\n", cache.numNodes, cache.numEdges);
+	for(int k=0; k<cache.numLengths; k++)
+	{
+		if(cache.status[k] == LENGTH_UNKNOWN)
+			continue;
+		fprintf(file, "%d %d", k, cache.status[k] == LENGTH_FEASIBLE);
+		for(int pos=0; cache.status[k] == LENGTH_FEASIBLE && pos<=k; pos++)
+			fprintf(file, " %d", cache.rank[cache.witnesses[k][pos]]);
+		fprintf(file, "\n");
+	}
+	fclose(file);
+	rename(temporary, cache.fileName);
+	free(temporary);
+}
+
+void deleteGraphCache(GraphCache cache)
+{
+	for(int k=0; k<cache.numLengths; k++)
+		free(cache.witnesses[k]);
+	free(cache.witnesses);
+	free(cache.status);
+	free(cache.rank);
+	free(cache.fileName);
+}
+
+LengthStatus getLengthStatus(GraphCache cache, int length)
+{
+	if(length < 0 || length >= cache.numLengths)
+		return LENGTH_INFEASIBLE;
+	return cache.status[length];
+}
+
+void setLengthFeasible(GraphCache *cache, int length, int *path)
+{
+	if(length < 0 || length >= cache->numLengths || cache->status[length] == LENGTH_FEASIBLE)
+		return;
+	cache->witnesses[length] = (int *)malloc((length+1)*sizeof(int));
+	memcpy(cache->witnesses[length], path, (length+1)*sizeof(int));
+	cache->status[length] = LENGTH_FEASIBLE;
+	cache->modified = true;
+}
+
+void setLengthInfeasible(GraphCache *cache, int length)
+{
+	if(length < 0 || length >= cache->numLengths || cache->status[length] != LENGTH_UNKNOWN)
+		return;
+	cache->status[length] = LENGTH_INFEASIBLE;
+	cache->modified = true;
+}
+
+Z3_lbool solveWithCache(Z3_context ctx, ReducedGraph *reduced, GraphCache *caches, PathLengths *lengths, unsigned int numGraphs, int length,
+						unsigned long searchBudget, int ***paths, unsigned int *numFoundInCache)
+{
+	*paths = NULL;
+	bool known = true;
+	for(unsigned int i=0; i<numGraphs; i++)
+	{
+		LengthStatus status = getLengthStatus(caches[i], length);
+		if(status == LENGTH_INFEASIBLE)
+		{
+			(*numFoundInCache)++;
+			return Z3_L_FALSE;
+		}
+		known = known && status == LENGTH_FEASIBLE;
+	}
+	if(known)
+		(*numFoundInCache)++;
+
+	for(unsigned int i=0; i<numGraphs; i++)
+	{
+		if(getLengthStatus(caches[i], length) == LENGTH_FEASIBLE)
+			continue;
+		/* the lengths computed for the graph, and the search without budget, decide the length alone */
+		bool computed = lengths != NULL && lengths[i].lengths != NULL;
+		int **path = NULL;
+		if(computed)
+		{
+			path = (int **)malloc(sizeof(int *));
+			path[0] = (int *)malloc((length+1)*sizeof(int));
+			if(!getLengthWitness(reduced[i].graph, lengths[i], length, path[0]))
+			{
+				deletePaths(path, 1);
+				path = NULL;
+			}
+		}
+		else if(searchBudget > 0)
+			path = findSimplePaths(&reduced[i].graph, 1, length, searchBudget, false);
+		Z3_lbool isSat = Z3_L_TRUE;
+		if(path == NULL && (computed || (searchBudget == UNLIMITED_BUDGET && !isDeadlinePassed())))
+			isSat = Z3_L_FALSE;
+		else if(path == NULL && isDeadlinePassed())
+			isSat = Z3_L_UNDEF;
+		else if(path == NULL)
+		{
+			Z3_model model;
+			isSat = solveFormula(ctx, graphsToPathFormula(ctx, &reduced[i].graph, 1, length), &model);
+			if(isSat == Z3_L_TRUE)
+				path = getPathsFromModel(ctx, model, &reduced[i].graph, 1, length);
+			if(model)
+				Z3_model_dec_ref(ctx, model);
+		}
+		if(isSat == Z3_L_FALSE)
+			setLengthInfeasible(&caches[i], length);
+		if(isSat != Z3_L_TRUE)
+			return isSat;
+		liftPaths(&reduced[i], 1, length, path);
+		setLengthFeasible(&caches[i], length, path[0]);
+		deletePaths(path, 1);
+	}
+
+	*paths = (int **)malloc(numGraphs*sizeof(int *));
+	for(unsigned int i=0; i<numGraphs; i++)
+	{
+		(*paths)[i] = (int *)malloc((length+1)*sizeof(int));
+		memcpy((*paths)[i], caches[i].witnesses[length], (length+1)*sizeof(int));
+	}
+	return Z3_L_TRUE;
+}
+
+Z3_lbool findCachedLength(Z3_context ctx, ReducedGraph *reduced, GraphCache *caches, PathLengths *lengths, unsigned int numGraphs,
+						  unsigned long searchBudget, int *length, int ***paths, unsigned int *numFoundInCache)
+{
+	Graph *reducedGraphs = getReducedGraphs(reduced, numGraphs);
+	int maxLength;
+	bool *possible = possibleCommonLengths(reducedGraphs, numGraphs, &maxLength);
+	free(reducedGraphs);
+	*paths = NULL;
+	bool undecided = false;	// a length not decided in the time given makes NON unproven
+	int k;
+	for(k=0; k<=maxLength && *paths == NULL; k++)
+	{
+		if(possible[k])
+			undecided = solveWithCache(ctx, reduced, caches, lengths, numGraphs, k, searchBudget, paths, numFoundInCache) == Z3_L_UNDEF || undecided;
+	}
+	*length = k-1;
+	free(possible);
+	if(*paths != NULL)
+		return Z3_L_TRUE;
+	return undecided ? Z3_L_UNDEF : Z3_L_FALSE;
+}
@@ -0,0 +1,391 @@
+/**
+ * @file Dynamic.c
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief An implementation of \ref Dynamic.h function's
+ * @date 2019
+ */
+
+
+#include "Dynamic.h"
+#include "Preprocessing.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define WORD_BITS			64						// the lengths of a state are the bits of unsigned long long words
+#define INITIAL_CAPACITY	1024					// the size of the hash table of the states when the first one is added
+#define HASH_MULTIPLIER		0x9E3779B97F4A7C15ULL	// mixes the last node of a state with its nodes visited
+#define HASH_MIXER			0xBF58476D1CE4E5B9ULL	// spreads the bits of the set of nodes visited
+
+/**
+* @brief hashState gives the hash of a state
+* @param visited the nodes visited by the paths of the state
+* @param last the node they end at
+* @return the hash
+*/
+unsigned long hashState(unsigned long long visited, int last);
+
+/**
+* @brief insertState puts a state in the hash table of @p lengths, which must have a free slot
+* @param lengths the lengths being computed
+* @param state the state
+*/
+void insertState(PathLengths *lengths, unsigned long state);
+
+/**
+* @brief findState looks for a state in the hash table
+* @param lengths the lengths being computed
+* @param visited the nodes visited by the paths of the state
+* @param last the node they end at
+* @return the state, lengths->numStates if it has not been built
+*/
+unsigned long findState(PathLengths *lengths, unsigned long long visited, int last);
+
+/**
+* @brief addState builds a state without any length, growing the arrays and the hash table when they are half full
+* @param lengths the lengths being computed
+* @param visited the nodes visited by the paths of the state
+* @param last the node they end at
+* @return the new state
+*/
+unsigned long addState(PathLengths *lengths, unsigned long long visited, int last);
+
+/**
+* @brief shiftLengths adds @p shift to each length of a set of lengths, keeping only the ones up to @p limit
+* @param from the set of lengths, of @p numWords words
+* @param numWords the number of words of the sets
+* @param shift the length added
+* @param limit the greatest length kept
+* @param to filled with the set shifted
+* @return true if the set shifted is not empty
+*/
+bool shiftLengths(const unsigned long long *from, int numWords, int shift, int limit, unsigned long long *to);
+
+/**
+* @brief hasLength tells if the paths of a state have the length @p length
+* @param lengths the lengths computed
+* @param state the state
+* @param length the length
+* @return true if a path of the state has this length
+*/
+bool hasLength(PathLengths *lengths, unsigned long state, int length);
+
+
+unsigned long hashState(unsigned long long visited, int last)
+{
+	unsigned long long hash = (visited + (unsigned long long)last * HASH_MULTIPLIER) * HASH_MIXER;
+	return (unsigned long)(hash ^ (hash >> 31));
+}
+
+void insertState(PathLengths *lengths, unsigned long state)
+{
+	unsigned long slot = hashState(lengths->visited[state], lengths->last[state]) & (lengths->capacity - 1);
+	while(lengths->table[slot] != 0)
+		slot = (slot + 1) & (lengths->capacity - 1);
+	lengths->table[slot] = state + 1;
+}
+
+unsigned long findState(PathLengths *lengths, unsigned long long visited, int last)
+{
+	if(lengths->capacity == 0)
+		return lengths->numStates;
+	unsigned long slot = hashState(visited, last) & (lengths->capacity - 1);
+	while(lengths->table[slot] != 0)
+	{
+		unsigned long state = lengths->table[slot] - 1;
+		if(lengths->visited[state] == visited && lengths->last[state] == last)
+			return state;
+		slot = (slot + 1) & (lengths->capacity - 1);
+	}
+	return lengths->numStates;
+}
+
+unsigned long addState(PathLengths *lengths, unsigned long long visited, int last)
+{
+	/* the arrays of the states have half the size of the table, which is rebuilt when it grows */
+	if(2*(lengths->numStates + 1) > lengths->capacity)
+	{
+		lengths->capacity = lengths->capacity == 0 ? INITIAL_CAPACITY : 2*lengths->capacity;
+		lengths->visited = (unsigned long long *)realloc(lengths->visited, lengths->capacity/2*sizeof(unsigned long long));
+		lengths->last = (int *)realloc(lengths->last, lengths->capacity/2*sizeof(int));
+		lengths->reached = (unsigned long long *)realloc(lengths->reached, lengths->capacity/2*lengths->numWords*sizeof(unsigned long long));
+		free(lengths->table);
+		lengths->table = (unsigned long *)calloc(lengths->capacity, sizeof(unsigned long));
+		for(unsigned long state=0; state<lengths->numStates; state++)
+			insertState(lengths, state);
+	}
+	unsigned long state = lengths->numStates++;
+	lengths->visited[state] = visited;
+	lengths->last[state] = last;
+	memset(lengths->reached + state*lengths->numWords, 0, lengths->numWords*sizeof(unsigned long long));
+	insertState(lengths, state);
+	return state;
+}
+
+bool shiftLengths(const unsigned long long *from, int numWords, int shift, int limit, unsigned long long *to)
+{
+	int wordShift = shift / WORD_BITS, bitShift = shift % WORD_BITS;
+	bool empty = true;
+	for(int w=numWords-1; w>=0; w--)
+	{
+		unsigned long long word = 0;
+		if(w - wordShift >= 0)
+			word = from[w - wordShift] << bitShift;
+		if(w - wordShift - 1 >= 0 && bitShift > 0)
+			word |= from[w - wordShift - 1] >> (WORD_BITS - bitShift);
+		if(w*WORD_BITS > limit)
+			word = 0;
+		else if(limit - w*WORD_BITS < WORD_BITS - 1)
+			word &= (2ULL << (limit - w*WORD_BITS)) - 1;
+		to[w] = word;
+		empty = empty && word == 0;
+	}
+	return !empty;
+}
+
+bool hasLength(PathLengths *lengths, unsigned long state, int length)
+{
+	if(length < 0 || length >= lengths->numLengths)
+		return false;
+	return (lengths->reached[state*lengths->numWords + length/WORD_BITS] >> (length % WORD_BITS)) & 1;
+}
+
+bool computePathLengths(Graph graph, unsigned long maxStates, PathLengths *lengths)
+{
+	int order = orderG(graph);
+	lengths->numLengths = 0;
+	lengths->lengths = NULL;
+	lengths->numWords = 0;
+	lengths->numStates = 0;
+	lengths->visited = NULL;
+	lengths->last = NULL;
+	lengths->reached = NULL;
+	lengths->capacity = 0;
+	lengths->table = NULL;
+	if(order > MAX_DYNAMIC_NODES)
+		return false;
+
+	int source, target;
+	for(source=0; source<order && !isSource(graph, source); source++);
+	for(target=0; target<order && !isTarget(graph, target); target++);
+	int lower = -1, upper = -1;
+	if(source < order && target < order)
+		lengthBounds(graph, &lower, &upper);
+	if(upper == -1)
+	{
+		lengths->lengths = (bool *)calloc(1, sizeof(bool));
+		return true;
+	}
+	lengths->numLengths = upper + 1;
+	lengths->numWords = upper / WORD_BITS + 1;
+
+	/* a path is only extended to a node from which the target is not too far, and which can reach it without the nodes visited (through its predecessors) */
+	int *distance = (int *)malloc(order*sizeof(int));
+	shortestDistances(graph, target, false, distance);
+	unsigned long long *predecessors = (unsigned long long *)calloc(order, sizeof(unsigned long long));
+	for(int node=0; node<order; node++)
+	{
+		int *successors = getSuccessors(graph, node);
+		for(int i=0; i<numSuccessors(graph, node); i++)
+			predecessors[successors[i]] |= 1ULL << node;
+	}
+	unsigned long long *accepted = (unsigned long long *)calloc(lengths->numWords, sizeof(unsigned long long));
+	unsigned long long *shifted = (unsigned long long *)malloc(lengths->numWords*sizeof(unsigned long long));
+
+	/* the states are built by increasing number of nodes visited, so the lengths of a state are all known when it is reached in this loop */
+	addState(lengths, 1ULL << source, source);
+	lengths->reached[0] = 1;
+	/* a source which is also the target is a path of length 0 by itself, and no longer path can come back to it */
+	if(source == target)
+		accepted[0] |= 1;
+	bool complete = true;
+	for(unsigned long state=0; state<lengths->numStates && complete; state++)
+	{
+		unsigned long long visited = lengths->visited[state];
+		int node = lengths->last[state];
+		unsigned long long alive = 1ULL << target, frontier = alive;
+		while(frontier != 0)
+		{
+			unsigned long long next = 0;
+			for(int v=0; v<order; v++)
+			{
+				if((frontier >> v) & 1)
+					next |= predecessors[v];
+			}
+			frontier = next & ~alive & ~visited;
+			alive |= frontier;
+		}
+
+		int *successors = getSuccessors(graph, node);
+		for(int i=0; i<numSuccessors(graph, node) && complete; i++)
+		{
+			int successor = successors[i];
+			if(!((alive >> successor) & 1) || ((visited >> successor) & 1))
+				continue;
+			if(!shiftLengths(lengths->reached + state*lengths->numWords, lengths->numWords, successorWeight(graph, node, i), upper - distance[successor], shifted))
+				continue;
+			if(successor == target)
+			{
+				for(int w=0; w<lengths->numWords; w++)
+					accepted[w] |= shifted[w];
+				continue;
+			}
+			unsigned long long nextVisited = visited | 1ULL << successor;
+			unsigned long nextState = findState(lengths, nextVisited, successor);
+			if(nextState == lengths->numStates)
+			{
+				if(lengths->numStates >= maxStates)
+				{
+					complete = false;
+					continue;
+				}
+				nextState = addState(lengths, nextVisited, successor);
+			}
+			for(int w=0; w<lengths->numWords; w++)
+				lengths->reached[nextState*lengths->numWords + w] |= shifted[w];
+		}
+	}
+
+	if(complete)
+	{
+		lengths->lengths = (bool *)malloc(lengths->numLengths*sizeof(bool));
+		for(int k=0; k<lengths->numLengths; k++)
+			lengths->lengths[k] = (accepted[k/WORD_BITS] >> (k % WORD_BITS)) & 1;
+	}
+	else
+	{
+		deletePathLengths(*lengths);
+		lengths->lengths = NULL;
+		lengths->visited = NULL;
+		lengths->last = NULL;
+		lengths->reached = NULL;
+		lengths->table = NULL;
+	}
+	free(distance);
+	free(predecessors);
+	free(accepted);
+	free(shifted);
+	return complete;
+}
+
+bool getLengthWitness(Graph graph, PathLengths lengths, int pathLength, int *path)
+{
+	if(lengths.lengths == NULL || pathLength < 0 || pathLength >= lengths.numLengths || !lengths.lengths[pathLength])
+		return false;
+	int order = orderG(graph);
+	int source, target;
+	for(source=0; source<order && !isSource(graph, source); source++);
+	for(target=0; target<order && !isTarget(graph, target); target++);
+	if(source == target)
+	{
+		path[0] = source;
+		return pathLength == 0;
+	}
+	for(int pos=0; pos<=pathLength; pos++)
+		path[pos] = -1;
+	path[pathLength] = target;
+
+	/* the last state before the target, then each state comes from one with a node less, and a length shorter by the edge between their last nodes */
+	int length = pathLength;
+	unsigned long state = lengths.numStates;
+	for(unsigned long s=0; s<lengths.numStates && state == lengths.numStates; s++)
+	{
+		int weight = edgeWeight(graph, lengths.last[s], target);
+		if(weight > 0 && hasLength(&lengths, s, pathLength - weight))
+		{
+			state = s;
+			length = pathLength - weight;
+		}
+	}
+	while(state < lengths.numStates && lengths.last[state] != source)
+	{
+		int node = lengths.last[state];
+		path[length] = node;
+		unsigned long long before = lengths.visited[state] & ~(1ULL << node);
+		int *predecessors = getPredecessors(graph, node);
+		unsigned long previous = lengths.numStates;
+		for(int i=0; i<numPredecessors(graph, node) && previous == lengths.numStates; i++)
+		{
+			if(!((before >> predecessors[i]) & 1))
+				continue;
+			int weight = edgeWeight(graph, predecessors[i], node);
+			unsigned long s = findState(&lengths, before, predecessors[i]);
+			if(s < lengths.numStates && hasLength(&lengths, s, length - weight))
+			{
+				previous = s;
+				length -= weight;
+			}
+		}
+		state = previous;
+	}
+	path[0] = source;
+	return state < lengths.numStates;
+}
+
+void deletePathLengths(PathLengths lengths)
+{
+	free(lengths.lengths);
+	free(lengths.visited);
+	free(lengths.last);
+	free(lengths.reached);
+	free(lengths.table);
+}
+
+PathLengths *computeDynamicLengths(ReducedGraph *reduced, unsigned int numGraphs, int maxNodes, unsigned int *numComputed)
+{
+	PathLengths *lengths = (PathLengths *)malloc(numGraphs*sizeof(PathLengths));
+	unsigned int numFound = 0;
+	for(unsigned int i=0; i<numGraphs; i++)
+	{
+		lengths[i].lengths = NULL;
+		if(orderG(reduced[i].graph) <= maxNodes && computePathLengths(reduced[i].graph, MAX_DYNAMIC_STATES, &lengths[i]))
+			numFound++;
+	}
+	*numComputed += numFound;
+	if(numFound == 0)
+	{
+		free(lengths);
+		return NULL;
+	}
+	return lengths;
+}
+
+void restrictToDynamicLengths(bool *possible, int maxLength, PathLengths *lengths, unsigned int numGraphs)
+{
+	for(unsigned int i=0; i<numGraphs && lengths != NULL; i++)
+	{
+		for(int k=0; k<=maxLength && lengths[i].lengths != NULL; k++)
+			possible[k] = possible[k] && k < lengths[i].numLengths && lengths[i].lengths[k];
+	}
+}
+
+int **completePaths(ReducedGraph *reduced, PathLengths *lengths, unsigned int numGraphs, int pathLength, int **found)
+{
+	if(lengths == NULL)
+		return found;
+	int **paths = (int **)malloc(numGraphs*sizeof(int *));
+	int numFound = 0;
+	for(unsigned int i=0; i<numGraphs; i++)
+	{
+		if(lengths[i].lengths == NULL)
+			paths[i] = found[numFound++];
+		else
+		{
+			paths[i] = (int *)malloc((pathLength+1)*sizeof(int));
+			getLengthWitness(reduced[i].graph, lengths[i], pathLength, paths[i]);
+		}
+	}
+	free(found);
+	return paths;
+}
+
+void deleteDynamicLengths(PathLengths *lengths, unsigned int numGraphs)
+{
+	for(unsigned int i=0; i<numGraphs && lengths != NULL; i++)
+	{
+		if(lengths[i].lengths != NULL)
+			deletePathLengths(lengths[i]);
+	}
+	free(lengths);
+}
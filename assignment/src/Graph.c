@@ -17,6 +17,91 @@
 #include <string.h>
 #include <stdlib.h>
 
+/**
+ * @brief Sorts the successors of a node by insertion (lists are short and almost sorted in practice) and removes duplicates.
+ * 
+ * @param list The successors.
+ * @param weights The weights of the edges to the successors, moved along with them (may be NULL).
+ * @param size The number of successors.
+ * @return int The number of distinct successors, stored at the beginning of @p list.
+ */
+static int sortSuccessors(int *list, int *weights, int size){
+	for(int i = 1; i<size; i++){
+		int value = list[i];
+		int weight = (weights != NULL) ? weights[i] : 1;
+		int j = i-1;
+		while(j>=0 && list[j]>value){
+			list[j+1] = list[j];
+			if(weights != NULL) weights[j+1] = weights[j];
+			j--;
+		}
+		list[j+1] = value;
+		if(weights != NULL) weights[j+1] = weight;
+	}
+	int distinct = 0;
+	for(int i = 0; i<size; i++){
+		if(distinct == 0 || list[distinct-1] != list[i]){
+			list[distinct] = list[i];
+			if(weights != NULL) weights[distinct] = weights[i];
+			distinct++;
+		}
+	}
+	return distinct;
+}
+
+Graph makeGraph(int numNodes, char **names, bool *initial, bool *final, int numEdges, int *sources, int *targets, int *weights){
+	Graph res;
+	res.numNodes = numNodes;
+	res.nodes = (char **)malloc((numNodes+1)*sizeof(char*));
+	res.initial = (bool *)malloc((numNodes+1)*sizeof(bool));
+	res.final = (bool *)malloc((numNodes+1)*sizeof(bool));
+	for(int i = 0; i<numNodes; i++){
+		res.nodes[i] = (char *)malloc((strlen(names[i])+1)*sizeof(char));
+		strcpy(res.nodes[i],names[i]);
+		res.initial[i] = initial[i];
+		res.final[i] = final[i];
+	}
+
+	//Successor lists: counting the edges of each node, then placing them.
+	res.successorsIndex = (int *)calloc(numNodes+1,sizeof(int));
+	res.successors = (int *)malloc((numEdges+1)*sizeof(int));
+	res.weights = (weights != NULL) ? (int *)malloc((numEdges+1)*sizeof(int)) : NULL;
+	for(int i = 0; i<numEdges; i++) res.successorsIndex[sources[i]+1]++;
+	for(int i = 0; i<numNodes; i++) res.successorsIndex[i+1] += res.successorsIndex[i];
+	int *fill = (int *)malloc((numNodes+1)*sizeof(int));
+	memcpy(fill,res.successorsIndex,(numNodes+1)*sizeof(int));
+	for(int i = 0; i<numEdges; i++){
+		if(weights != NULL) res.weights[fill[sources[i]]] = weights[i];
+		res.successors[fill[sources[i]]++] = targets[i];
+	}
+	free(fill);
+
+	//Sorting and removing duplicated edges, then compacting the lists.
+	res.numEdges = 0;
+	for(int i = 0; i<numNodes; i++){
+		int start = res.successorsIndex[i];
+		int size = sortSuccessors(res.successors+start,(weights != NULL) ? res.weights+start : NULL,res.successorsIndex[i+1]-start);
+		memmove(res.successors+res.numEdges,res.successors+start,size*sizeof(int));
+		if(weights != NULL) memmove(res.weights+res.numEdges,res.weights+start,size*sizeof(int));
+		res.successorsIndex[i] = res.numEdges;
+		res.numEdges += size;
+	}
+	res.successorsIndex[numNodes] = res.numEdges;
+
+	//Predecessor lists: the transposed successor lists, sorted since nodes are visited in increasing order.
+	res.predecessorsIndex = (int *)calloc(numNodes+1,sizeof(int));
+	res.predecessors = (int *)malloc((res.numEdges+1)*sizeof(int));
+	for(int i = 0; i<res.numEdges; i++) res.predecessorsIndex[res.successors[i]+1]++;
+	for(int i = 0; i<numNodes; i++) res.predecessorsIndex[i+1] += res.predecessorsIndex[i];
+	fill = (int *)malloc((numNodes+1)*sizeof(int));
+	memcpy(fill,res.predecessorsIndex,(numNodes+1)*sizeof(int));
+	for(int i = 0; i<numNodes; i++)
+		for(int j = res.successorsIndex[i]; j<res.successorsIndex[i+1]; j++)
+			res.predecessors[fill[res.successors[j]]++] = i;
+	free(fill);
+	return res;
+}
+
 void printGraph(Graph graph){
 	printf("nodes:\n");
 	for(int i = 0; i<graph.numNodes;i++) printf("%d : %s, ",i,graph.nodes[i]);
@@ -27,14 +112,13 @@ void printGraph(Graph graph){
 	printf("\nEdges:\n");
 	for(int i = 0; i<graph.numNodes;i++){
 		for(int j = 0; j<graph.numNodes;j++){
-			printf("%d ",graph.edges[i*graph.numNodes+j]);
+			printf("%d ",isEdge(graph,i,j));
 		}
 		printf("\n");
 	}
 }
 
 void deleteGraph(Graph graph){
-	if(graph.edges!=NULL) free(graph.edges);
 	if(graph.nodes!=NULL){
 		for(int i = 0; i<graph.numNodes; i++) {
 			if(graph.nodes[i]!=NULL) free(graph.nodes[i]);
@@ -42,6 +126,12 @@ void deleteGraph(Graph graph){
 		free(graph.nodes);
 	}
 
+	if(graph.successors!=NULL) free(graph.successors);
+	if(graph.successorsIndex!=NULL) free(graph.successorsIndex);
+	if(graph.weights!=NULL) free(graph.weights);
+	if(graph.predecessors!=NULL) free(graph.predecessors);
+	if(graph.predecessorsIndex!=NULL) free(graph.predecessorsIndex);
+
 	//Pour les automates.
 	if(graph.initial!=NULL) free(graph.initial);
 	if(graph.final!=NULL) free(graph.final);
@@ -58,8 +148,54 @@ int sizeG(Graph graph){
 	return graph.numEdges;
 }
 
+int findSuccessor(Graph graph, int source, int target){
+	int low = graph.successorsIndex[source];
+	int high = graph.successorsIndex[source+1]-1;
+	while(low<=high){
+		int middle = (low+high)/2;
+		if(graph.successors[middle] == target) return middle-graph.successorsIndex[source];
+		if(graph.successors[middle] < target) low = middle+1;
+		else high = middle-1;
+	}
+	return -1;
+}
+
 bool isEdge(Graph graph, int source, int target){
-	return graph.edges[(source*graph.numNodes)+target];
+	return findSuccessor(graph,source,target) != -1;
+}
+
+int successorWeight(Graph graph, int node, int index){
+	if(graph.weights == NULL) return 1;
+	return graph.weights[graph.successorsIndex[node]+index];
+}
+
+int edgeWeight(Graph graph, int source, int target){
+	int index = findSuccessor(graph,source,target);
+	if(index == -1) return 0;
+	return successorWeight(graph,source,index);
+}
+
+int maxPathLength(Graph graph){
+	int length = graph.numNodes-1;
+	if(graph.weights != NULL)
+		for(int i = 0; i<graph.numEdges; i++) length += graph.weights[i]-1;
+	return length;
+}
+
+int numSuccessors(Graph graph, int node){
+	return graph.successorsIndex[node+1]-graph.successorsIndex[node];
+}
+
+int* getSuccessors(Graph graph, int node){
+	return graph.successors+graph.successorsIndex[node];
+}
+
+int numPredecessors(Graph graph, int node){
+	return graph.predecessorsIndex[node+1]-graph.predecessorsIndex[node];
+}
+
+int* getPredecessors(Graph graph, int node){
+	return graph.predecessors+graph.predecessorsIndex[node];
 }
 
 bool isSource(Graph graph, int node){
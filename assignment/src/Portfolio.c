@@ -0,0 +1,125 @@
+/**
+ * @file Portfolio.c
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief An implementation of \ref Portfolio.h function's
+ * @date 2019
+ */
+
+
+#include "Portfolio.h"
+#include "Query.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+
+int racePortfolio(int argc, char **argv, char **engines, int numEngines, bool printStats, bool answerStatus)
+{
+	pid_t processes[numEngines];
+	struct pollfd outputs[numEngines];
+	char *answers[numEngines];		// what each engine displayed
+	size_t answerSizes[numEngines];
+	int statuses[numEngines];		// the exit status of each engine which has ended
+	for(int e=0; e<numEngines; e++)
+	{
+		/* the options of the engine come after the others, so that they replace them, and -x makes its exit status tell its answer */
+		char options[strlen(engines[e])+1];
+		strcpy(options, engines[e]);
+		char *engineArgv[argc + strlen(options)/2 + 3];
+		int engineArgc = 0;
+		for(int i=0; i<argc; i++)
+			engineArgv[engineArgc++] = argv[i];
+		engineArgv[engineArgc++] = (char *)"-x";
+		for(char *option = strtok(options, " \t"); option != NULL; option = strtok(NULL, " \t"))
+			engineArgv[engineArgc++] = option;
+		engineArgv[engineArgc] = NULL;
+
+		int channel[2];
+		fflush(stdout);
+		if(pipe(channel) != 0 || (processes[e] = fork()) < 0)
+		{
+			fprintf(stderr, "Could not start the engine %s\n", engines[e]);
+			exit(EXIT_FAILURE);
+		}
+		if(processes[e] == 0)
+		{
+			dup2(channel[1], STDOUT_FILENO);
+			close(channel[0]);
+			close(channel[1]);
+			execvp(argv[0], engineArgv);
+			fprintf(stderr, "Could not run %s\n", argv[0]);
+			_exit(EXIT_FAILURE);
+		}
+		close(channel[1]);
+		outputs[e].fd = channel[0];
+		outputs[e].events = POLLIN;
+		answers[e] = NULL;
+		answerSizes[e] = 0;
+	}
+
+	int winner = -1, fallback = -1, numRunning = numEngines;
+	while(winner == -1 && numRunning > 0)
+	{
+		poll(outputs, numEngines, -1);
+		for(int e=0; e<numEngines && winner == -1; e++)
+		{
+			if(outputs[e].fd < 0 || outputs[e].revents == 0)
+				continue;
+			char buffer[4096];
+			ssize_t size = read(outputs[e].fd, buffer, sizeof(buffer));
+			if(size > 0)
+			{
+				answers[e] = (char *)realloc(answers[e], answerSizes[e] + size + 1);
+				memcpy(answers[e] + answerSizes[e], buffer, size);
+				answerSizes[e] += size;
+				answers[e][answerSizes[e]] = '\0';
+				continue;
+			}
+			/* the engine has ended: its answer counts if it did not fail, and wins if it decided */
+			close(outputs[e].fd);
+			outputs[e].fd = -1;
+			numRunning--;
+			int status;
+			waitpid(processes[e], &status, 0);
+			processes[e] = 0;
+			if(!WIFEXITED(status) || answers[e] == NULL)
+				continue;
+			statuses[e] = WEXITSTATUS(status);
+			if(statuses[e] == EXIT_FOUND || statuses[e] == EXIT_NOT_FOUND)
+				winner = e;
+			else if(statuses[e] == EXIT_UNDECIDED && fallback == -1)
+				fallback = e;
+		}
+	}
+
+	/* the engines still running are stopped */
+	for(int e=0; e<numEngines; e++)
+	{
+		if(processes[e] != 0)
+		{
+			kill(processes[e], SIGTERM);
+			waitpid(processes[e], NULL, 0);
+			close(outputs[e].fd);
+		}
+	}
+	if(winner == -1)
+		winner = fallback;
+	if(winner != -1)
+	{
+		fputs(answers[winner], stdout);
+		if(printStats)
+			printf("portfolio: engine %d (\"%s\") answered first among %d\n", winner+1, engines[winner], numEngines);
+	}
+	else
+		fprintf(stderr, "No engine answered\n");
+	int status = EXIT_FAILURE;
+	if(winner != -1)
+		status = answerStatus ? statuses[winner] : EXIT_SUCCESS;
+	for(int e=0; e<numEngines; e++)
+		free(answers[e]);
+	return status;
+}
@@ -0,0 +1,677 @@
+/**
+ * @file Preprocessing.c
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief An implementation of \ref Preprocessing.h function's
+ * @date 2019
+ */
+
+
+#include "Preprocessing.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+* @brief markReachable marks the nodes reachable from @p start, following successors if @p forward is true and predecessors otherwise
+* @param graph the graph
+* @param start the node to start from
+* @param forward the direction of the edges
+* @param usable the edges considered are the ones whose both ends are usable
+* @param reached filled with true for the nodes reached, false for the others
+*/
+void markReachable(Graph graph, int start, bool forward, bool *usable, bool *reached);
+
+/**
+* @brief isUsefulEdge tells if the edge (@p source, @p target) may belong to a simple accepting path, regardless of reachability
+* @param graph the graph
+* @param source the source of the edge
+* @param target the target of the edge
+* @return false for self-loops, edges going to the source of @p graph and edges leaving its target
+*/
+bool isUsefulEdge(Graph graph, int source, int target);
+
+/**
+* @brief cutChain shortens a contracted edge by one node: the last node of its chain becomes a node of the contracted graph, linked to the old end of the edge
+* @param edge the edge to cut, in @p sources, @p targets and @p weights (it must have a chain)
+* @param node the node of the graph which is the last one of the chain of @p edge
+* @param newNode the new identifiers of the nodes, where an identifier is given to @p node
+* @param numNodes the number of nodes of the contracted graph, incremented
+* @param numEdges the number of edges, incremented by the edge added from @p node
+*/
+void cutChain(int edge, int node, int *newNode, int *numNodes, int *sources, int *targets, int *weights, int *numEdges);
+
+
+
+
+bool isUsefulEdge(Graph graph, int source, int target)
+{
+	return source != target && !isSource(graph, target) && !isTarget(graph, source);
+}
+
+void markReachable(Graph graph, int start, bool forward, bool *usable, bool *reached)
+{
+	int order = orderG(graph);
+	int *stack = (int *)malloc((order+1)*sizeof(int));
+	int stackSize = 0;
+	for(int node=0; node<order; node++)
+		reached[node] = false;
+
+	reached[start] = true;
+	stack[stackSize++] = start;
+	while(stackSize > 0)
+	{
+		int node = stack[--stackSize];
+		int numNeighbours = forward ? numSuccessors(graph, node) : numPredecessors(graph, node);
+		int *neighbours = forward ? getSuccessors(graph, node) : getPredecessors(graph, node);
+		for(int i=0; i<numNeighbours; i++)
+		{
+			int neighbour = neighbours[i];
+			bool useful = forward ? isUsefulEdge(graph, node, neighbour) : isUsefulEdge(graph, neighbour, node);
+			if(useful && usable[neighbour] && !reached[neighbour])
+			{
+				reached[neighbour] = true;
+				stack[stackSize++] = neighbour;
+			}
+		}
+	}
+	free(stack);
+}
+
+ReducedGraph reduceGraph(Graph graph)
+{
+	int order = orderG(graph);
+	int source, target;
+	for(source=0; source<order && !isSource(graph, source); source++);
+	for(target=0; target<order && !isTarget(graph, target); target++);
+
+	/* useful nodes: reachable from the source, then among them, the ones from which the target is reachable */
+	bool *usable = (bool *)malloc((order+1)*sizeof(bool));
+	bool *fromSource = (bool *)malloc((order+1)*sizeof(bool));
+	bool *toTarget = (bool *)malloc((order+1)*sizeof(bool));
+	for(int node=0; node<order; node++)
+		usable[node] = true;
+	markReachable(graph, source, true, usable, fromSource);
+	markReachable(graph, target, false, fromSource, toTarget);
+	toTarget[source] = true;
+
+	/* new identifiers of the kept nodes, in the same order as in the original graph */
+	ReducedGraph reduced;
+	int *newNode = (int *)malloc((order+1)*sizeof(int));
+	reduced.originalNode = (int *)malloc((order+1)*sizeof(int));
+	char **names = (char **)malloc((order+1)*sizeof(char *));
+	bool *initial = (bool *)malloc((order+1)*sizeof(bool));
+	bool *final = (bool *)malloc((order+1)*sizeof(bool));
+	int numNodes = 0;
+	for(int node=0; node<order; node++)
+	{
+		newNode[node] = -1;
+		if(toTarget[node])
+		{
+			newNode[node] = numNodes;
+			reduced.originalNode[numNodes] = node;
+			names[numNodes] = getNodeName(graph, node);
+			initial[numNodes] = isSource(graph, node);
+			final[numNodes] = isTarget(graph, node);
+			numNodes++;
+		}
+	}
+
+	int *sources = (int *)malloc((sizeG(graph)+1)*sizeof(int));
+	int *targets = (int *)malloc((sizeG(graph)+1)*sizeof(int));
+	int numEdges = 0;
+	for(int node=0; node<order; node++)
+	{
+		if(newNode[node] == -1)
+			continue;
+		int *successors = getSuccessors(graph, node);
+		for(int i=0; i<numSuccessors(graph, node); i++)
+		{
+			if(newNode[successors[i]] != -1 && isUsefulEdge(graph, node, successors[i]))
+			{
+				sources[numEdges] = newNode[node];
+				targets[numEdges] = newNode[successors[i]];
+				numEdges++;
+			}
+		}
+	}
+
+	reduced.graph = makeGraph(numNodes, names, initial, final, numEdges, sources, targets, NULL);
+	reduced.chainStart = NULL;
+	reduced.chainNodes = NULL;
+
+	free(usable);
+	free(fromSource);
+	free(toTarget);
+	free(newNode);
+	free(names);
+	free(initial);
+	free(final);
+	free(sources);
+	free(targets);
+	return reduced;
+}
+
+void cutChain(int edge, int node, int *newNode, int *numNodes, int *sources, int *targets, int *weights, int *numEdges)
+{
+	newNode[node] = (*numNodes)++;
+	sources[*numEdges] = newNode[node];
+	targets[*numEdges] = targets[edge];
+	weights[*numEdges] = 1;
+	(*numEdges)++;
+	targets[edge] = newNode[node];
+	weights[edge]--;
+}
+
+ReducedGraph contractChains(ReducedGraph reduced)
+{
+	Graph graph = reduced.graph;
+	int order = orderG(graph);
+	int size = sizeG(graph);
+
+	/* nodes of chains, and new identifiers of the other ones (the nodes of chains cut later are numbered after them) */
+	bool *inChain = (bool *)malloc((order+1)*sizeof(bool));
+	int *newNode = (int *)malloc((order+1)*sizeof(int));
+	int numNodes = 0;
+	for(int node=0; node<order; node++)
+	{
+		inChain[node] = !isSource(graph, node) && !isTarget(graph, node) && numPredecessors(graph, node) == 1 && numSuccessors(graph, node) == 1;
+		newNode[node] = inChain[node] ? -1 : numNodes++;
+	}
+
+	/*
+	* the chain of the e-th edge is chain[chainOffset[e]] to chain[chainOffset[e]+weights[e]-2], nodes of the chain being given as the graph indexes them
+	* lastSource[x] and edgeTo[x] tell which node has been the last one to get an edge to x, and which edge it was, to find duplicated edges
+	*/
+	int *sources = (int *)malloc((size+1)*sizeof(int));
+	int *targets = (int *)malloc((size+1)*sizeof(int));
+	int *weights = (int *)malloc((size+1)*sizeof(int));
+	int *chainOffset = (int *)malloc((size+1)*sizeof(int));
+	int *chain = (int *)malloc((order+1)*sizeof(int));
+	int *lastSource = (int *)malloc((order+1)*sizeof(int));
+	int *edgeTo = (int *)malloc((order+1)*sizeof(int));
+	int numEdges = 0, chainSize = 0;
+	for(int node=0; node<order; node++)
+		lastSource[node] = -1;
+
+	for(int node=0; node<order; node++)
+	{
+		if(inChain[node])
+			continue;
+		int *successors = getSuccessors(graph, node);
+		for(int i=0; i<numSuccessors(graph, node); i++)
+		{
+			/* following the chain: its nodes have a single successor, and a single predecessor so that it cannot loop without coming back to node */
+			int offset = chainSize;
+			int end = successors[i];
+			while(inChain[end])
+			{
+				chain[chainSize++] = end;
+				end = getSuccessors(graph, end)[0];
+			}
+			if(end == node)
+			{
+				chainSize = offset;
+				continue;
+			}
+
+			sources[numEdges] = newNode[node];
+			targets[numEdges] = newNode[end];
+			weights[numEdges] = chainSize - offset + 1;
+			chainOffset[numEdges] = offset;
+			numEdges++;
+
+			/* two edges from node to end: one of them has a chain (there is only one direct edge), which is cut before its last node */
+			if(lastSource[end] == node)
+			{
+				int edge = (weights[numEdges-1] > 1) ? numEdges-1 : edgeTo[end];
+				cutChain(edge, chain[chainOffset[edge] + weights[edge] - 2], newNode, &numNodes, sources, targets, weights, &numEdges);
+				chainOffset[numEdges-1] = chainSize;
+				if(edge != numEdges-2)
+					edgeTo[end] = numEdges-2;
+			}
+			else
+			{
+				lastSource[end] = node;
+				edgeTo[end] = numEdges-1;
+			}
+		}
+	}
+
+	bool weighted = false;
+	for(int edge=0; edge<numEdges; edge++)
+		weighted = weighted || weights[edge] > 1;
+
+	ReducedGraph contracted;
+	contracted.originalNode = (int *)malloc((numNodes+1)*sizeof(int));
+	char **names = (char **)malloc((numNodes+1)*sizeof(char *));
+	bool *initial = (bool *)malloc((numNodes+1)*sizeof(bool));
+	bool *final = (bool *)malloc((numNodes+1)*sizeof(bool));
+	for(int node=0; node<order; node++)
+	{
+		if(newNode[node] == -1)
+			continue;
+		contracted.originalNode[newNode[node]] = reduced.originalNode[node];
+		names[newNode[node]] = getNodeName(graph, node);
+		initial[newNode[node]] = isSource(graph, node);
+		final[newNode[node]] = isTarget(graph, node);
+	}
+	contracted.graph = makeGraph(numNodes, names, initial, final, numEdges, sources, targets, weighted ? weights : NULL);
+	contracted.chainStart = NULL;
+	contracted.chainNodes = NULL;
+
+	/* the edges are sorted by makeGraph: their chains are found back with their ends */
+	if(weighted)
+	{
+		contracted.chainStart = (int *)malloc((numEdges+1)*sizeof(int));
+		contracted.chainNodes = (int *)malloc((chainSize+1)*sizeof(int));
+		for(int i=0; i<chainSize; i++)
+			contracted.chainNodes[i] = reduced.originalNode[chain[i]];
+		for(int edge=0; edge<numEdges; edge++)
+		{
+			int index = findSuccessor(contracted.graph, sources[edge], targets[edge]);
+			contracted.chainStart[contracted.graph.successorsIndex[sources[edge]] + index] = chainOffset[edge];
+		}
+	}
+
+	free(inChain);
+	free(newNode);
+	free(sources);
+	free(targets);
+	free(weights);
+	free(chainOffset);
+	free(chain);
+	free(lastSource);
+	free(edgeTo);
+	free(names);
+	free(initial);
+	free(final);
+	return contracted;
+}
+
+void shortestDistances(Graph graph, int start, bool forward, int *distance)
+{
+	/* edges have small positive lengths: nodes are visited by increasing distance, with a list of nodes for each distance (an entry is ignored if the node has been reached closer since) */
+	int order = orderG(graph);
+	int maxDistance = maxPathLength(graph);
+	int *head = (int *)malloc((maxDistance+1)*sizeof(int));
+	int *entryNode = (int *)malloc((sizeG(graph)+2)*sizeof(int));
+	int *entryNext = (int *)malloc((sizeG(graph)+2)*sizeof(int));
+	int numEntries = 0;
+	for(int d=0; d<=maxDistance; d++)
+		head[d] = -1;
+	for(int node=0; node<order; node++)
+		distance[node] = -1;
+
+	distance[start] = 0;
+	entryNode[numEntries] = start;
+	entryNext[numEntries] = head[0];
+	head[0] = numEntries++;
+	for(int d=0; d<=maxDistance; d++)
+	{
+		for(int entry=head[d]; entry!=-1; entry=entryNext[entry])
+		{
+			int node = entryNode[entry];
+			if(distance[node] != d)
+				continue;
+			int numNeighbours = forward ? numSuccessors(graph, node) : numPredecessors(graph, node);
+			int *neighbours = forward ? getSuccessors(graph, node) : getPredecessors(graph, node);
+			for(int i=0; i<numNeighbours; i++)
+			{
+				int next = d + (forward ? successorWeight(graph, node, i) : edgeWeight(graph, neighbours[i], node));
+				if(next <= maxDistance && (distance[neighbours[i]] == -1 || next < distance[neighbours[i]]))
+				{
+					distance[neighbours[i]] = next;
+					entryNode[numEntries] = neighbours[i];
+					entryNext[numEntries] = head[next];
+					head[next] = numEntries++;
+				}
+			}
+		}
+	}
+	free(head);
+	free(entryNode);
+	free(entryNext);
+}
+
+int stronglyConnectedComponents(Graph graph, int *component)
+{
+	int order = orderG(graph);
+	int *index = (int *)malloc(order*sizeof(int));
+	int *low = (int *)malloc(order*sizeof(int));
+	int *nextChild = (int *)malloc(order*sizeof(int));
+	int *callStack = (int *)malloc(order*sizeof(int));
+	int *stack = (int *)malloc(order*sizeof(int));
+	bool *onStack = (bool *)calloc(order, sizeof(bool));
+	for(int node=0; node<order; node++)
+		index[node] = -1;
+
+	/* callStack holds the nodes whose successors are being visited, stack the nodes whose component is not known yet */
+	int counter = 0, numComponents = 0, top = 0;
+	for(int root=0; root<order; root++)
+	{
+		if(index[root] != -1)
+			continue;
+		int depth = 0;
+		callStack[0] = root;
+		index[root] = low[root] = counter++;
+		nextChild[root] = 0;
+		stack[top++] = root;
+		onStack[root] = true;
+		while(depth >= 0)
+		{
+			int node = callStack[depth];
+			if(nextChild[node] < numSuccessors(graph, node))
+			{
+				int successor = getSuccessors(graph, node)[nextChild[node]++];
+				if(index[successor] == -1)
+				{
+					index[successor] = low[successor] = counter++;
+					nextChild[successor] = 0;
+					stack[top++] = successor;
+					onStack[successor] = true;
+					callStack[++depth] = successor;
+				}
+				else if(onStack[successor] && index[successor] < low[node])
+					low[node] = index[successor];
+				continue;
+			}
+			if(low[node] == index[node])
+			{
+				int member;
+				do
+				{
+					member = stack[--top];
+					onStack[member] = false;
+					component[member] = numComponents;
+				} while(member != node);
+				numComponents++;
+			}
+			depth--;
+			if(depth >= 0 && low[node] < low[callStack[depth]])
+				low[callStack[depth]] = low[node];
+		}
+	}
+	free(index);
+	free(low);
+	free(nextChild);
+	free(callStack);
+	free(stack);
+	free(onStack);
+	return numComponents;
+}
+
+void lengthBounds(Graph graph, int *lower, int *upper)
+{
+	int order = orderG(graph);
+	int source, target;
+	for(source=0; source<order && !isSource(graph, source); source++);
+	for(target=0; target<order && !isTarget(graph, target); target++);
+	*lower = *upper = -1;
+	if(source == order || target == order)
+		return;
+
+	int *distance = (int *)malloc(order*sizeof(int));
+	shortestDistances(graph, source, true, distance);
+	*lower = distance[target];
+	free(distance);
+	if(*lower == -1)
+		return;
+
+	int *component = (int *)malloc(order*sizeof(int));
+	int numComponents = stronglyConnectedComponents(graph, component);
+	int *weight = (int *)calloc(numComponents, sizeof(int));
+	int *longest = (int *)malloc(numComponents*sizeof(int));
+	for(int node=0; node<order; node++)
+	{
+		int longestEdge = 0;
+		for(int i=0; i<numSuccessors(graph, node); i++)
+		{
+			if(successorWeight(graph, node, i) > longestEdge)
+				longestEdge = successorWeight(graph, node, i);
+		}
+		if(node != target)
+			weight[component[node]] += longestEdge;
+	}
+
+	/* the components are handled in reverse topological order, so the ones after a component are handled before it (-1: the target cannot be reached) */
+	for(int c=0; c<numComponents; c++)
+		longest[c] = c == component[target] ? 0 : -1;
+	int *nodesByComponent = (int *)malloc(order*sizeof(int));
+	int *componentStart = (int *)calloc(numComponents+1, sizeof(int));
+	for(int node=0; node<order; node++)
+		componentStart[component[node]+1]++;
+	for(int c=0; c<numComponents; c++)
+		componentStart[c+1] += componentStart[c];
+	int *fill = (int *)malloc(numComponents*sizeof(int));
+	memcpy(fill, componentStart, numComponents*sizeof(int));
+	for(int node=0; node<order; node++)
+		nodesByComponent[fill[component[node]]++] = node;
+	for(int c=0; c<numComponents; c++)
+	{
+		if(c == component[target])
+			continue;
+		int best = -1;
+		for(int i=componentStart[c]; i<componentStart[c+1]; i++)
+		{
+			int node = nodesByComponent[i];
+			int *successors = getSuccessors(graph, node);
+			for(int j=0; j<numSuccessors(graph, node); j++)
+			{
+				int next = component[successors[j]];
+				if(next != c && longest[next] > best)
+					best = longest[next];
+			}
+		}
+		if(best != -1)
+			longest[c] = weight[c] + best;
+	}
+	*upper = longest[component[source]];
+	if(*upper > maxPathLength(graph))
+		*upper = maxPathLength(graph);
+
+	free(component);
+	free(weight);
+	free(longest);
+	free(nodesByComponent);
+	free(componentStart);
+	free(fill);
+}
+
+void lengthPeriod(Graph graph, int *period, int *residue)
+{
+	int order = orderG(graph);
+	int source, target;
+	for(source=0; source<order && !isSource(graph, source); source++);
+	for(target=0; target<order && !isTarget(graph, target); target++);
+	*period = 0;
+	*residue = -1;
+	if(source == order || target == order)
+		return;
+
+	int *fromSource = (int *)malloc(order*sizeof(int));
+	int *toTarget = (int *)malloc(order*sizeof(int));
+	shortestDistances(graph, source, true, fromSource);
+	shortestDistances(graph, target, false, toTarget);
+	if(fromSource[target] != -1)
+	{
+		for(int node=0; node<order; node++)
+		{
+			if(fromSource[node] == -1 || toTarget[node] == -1)
+				continue;
+			int *successors = getSuccessors(graph, node);
+			for(int i=0; i<numSuccessors(graph, node); i++)
+			{
+				if(toTarget[successors[i]] == -1)
+					continue;
+				/* the shift is not negative since the distances are the shortest ones */
+				int a = fromSource[node] + successorWeight(graph, node, i) - fromSource[successors[i]];
+				int b = *period;
+				while(b != 0)
+				{
+					int r = a % b;
+					a = b;
+					b = r;
+				}
+				*period = a;
+			}
+		}
+		*residue = *period > 0 ? fromSource[target] % *period : fromSource[target];
+	}
+	free(fromSource);
+	free(toTarget);
+}
+
+int mandatoryNodes(Graph graph, int *nodes)
+{
+	int order = orderG(graph);
+	int source, target;
+	for(source=0; source<order && !isSource(graph, source); source++);
+	for(target=0; target<order && !isTarget(graph, target); target++);
+	if(source == order || target == order)
+		return 0;
+
+	/* postorder of a depth-first search from the source (-1: not reached) */
+	int *postorder = (int *)malloc(order*sizeof(int));
+	int *byPostorder = (int *)malloc(order*sizeof(int));
+	int *nextChild = (int *)calloc(order, sizeof(int));
+	int *callStack = (int *)malloc(order*sizeof(int));
+	for(int node=0; node<order; node++)
+		postorder[node] = -1;
+	bool *visited = (bool *)calloc(order, sizeof(bool));
+	int numVisited = 0, depth = 0;
+	callStack[0] = source;
+	visited[source] = true;
+	while(depth >= 0)
+	{
+		int node = callStack[depth];
+		if(nextChild[node] < numSuccessors(graph, node))
+		{
+			int successor = getSuccessors(graph, node)[nextChild[node]++];
+			if(!visited[successor])
+			{
+				visited[successor] = true;
+				callStack[++depth] = successor;
+			}
+			continue;
+		}
+		byPostorder[numVisited] = node;
+		postorder[node] = numVisited++;
+		depth--;
+	}
+
+	/* immediate dominators, refined in reverse postorder until they do not change; two dominators are merged by climbing to their common ancestor */
+	int *idom = (int *)malloc(order*sizeof(int));
+	for(int node=0; node<order; node++)
+		idom[node] = -1;
+	idom[source] = source;
+	bool changed = true;
+	while(changed)
+	{
+		changed = false;
+		for(int i=numVisited-1; i>=0; i--)
+		{
+			int node = byPostorder[i];
+			if(node == source)
+				continue;
+			int newIdom = -1;
+			int *predecessors = getPredecessors(graph, node);
+			for(int j=0; j<numPredecessors(graph, node); j++)
+			{
+				int other = predecessors[j];
+				if(idom[other] == -1)
+					continue;
+				if(newIdom == -1)
+				{
+					newIdom = other;
+					continue;
+				}
+				while(other != newIdom)
+				{
+					while(postorder[other] < postorder[newIdom])
+						other = idom[other];
+					while(postorder[newIdom] < postorder[other])
+						newIdom = idom[newIdom];
+				}
+			}
+			if(newIdom != idom[node])
+			{
+				idom[node] = newIdom;
+				changed = true;
+			}
+		}
+	}
+
+	/* the dominators of the target, from the target up to the source, are written in reverse */
+	int numNodes = 0;
+	if(idom[target] != -1)
+	{
+		for(int node=idom[target]; node!=source; node=idom[node])
+			numNodes++;
+		int i = numNodes;
+		for(int node=idom[target]; node!=source; node=idom[node])
+			nodes[--i] = node;
+	}
+	free(postorder);
+	free(byPostorder);
+	free(nextChild);
+	free(callStack);
+	free(visited);
+	free(idom);
+	return numNodes;
+}
+
+void deleteReducedGraph(ReducedGraph reduced)
+{
+	deleteGraph(reduced.graph);
+	free(reduced.originalNode);
+	if(reduced.chainStart != NULL)
+		free(reduced.chainStart);
+	if(reduced.chainNodes != NULL)
+		free(reduced.chainNodes);
+}
+
+void liftPaths(ReducedGraph *reduced, int numGraphs, int pathLength, int **paths)
+{
+	int *lifted = (int *)malloc((pathLength+1)*sizeof(int));
+	for(int i=0; i<numGraphs; i++)
+	{
+		Graph graph = reduced[i].graph;
+		int last = -1;
+		for(int pos=0; pos<=pathLength; pos++)
+		{
+			lifted[pos] = -1;
+			if(paths[i][pos] == -1)
+				continue;
+			lifted[pos] = reduced[i].originalNode[paths[i][pos]];
+
+			/* the positions between two nodes of the path are the ones of the chain of the edge between them */
+			int index = (last == -1) ? -1 : findSuccessor(graph, paths[i][last], paths[i][pos]);
+			if(index != -1 && reduced[i].chainStart != NULL)
+			{
+				int start = reduced[i].chainStart[graph.successorsIndex[paths[i][last]] + index];
+				for(int crossed=last+1; crossed<pos; crossed++)
+					lifted[crossed] = reduced[i].chainNodes[start + crossed - last - 1];
+			}
+			last = pos;
+		}
+		memcpy(paths[i], lifted, (pathLength+1)*sizeof(int));
+	}
+	free(lifted);
+}
+
+ReducedGraph simplifyGraph(Graph graph)
+{
+	ReducedGraph useful = reduceGraph(graph);
+	ReducedGraph reduced = contractChains(useful);
+	deleteReducedGraph(useful);
+	return reduced;
+}
+
+Graph *getReducedGraphs(ReducedGraph *reduced, unsigned int numGraphs)
+{
+	Graph *reducedGraphs = (Graph *)malloc(numGraphs*sizeof(Graph));
+	for(unsigned int i=0; i<numGraphs; i++)
+		reducedGraphs[i] = reduced[i].graph;
+	return reducedGraphs;
+}
@@ -0,0 +1,659 @@
+/**
+ * @file Query.c
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief An implementation of \ref Query.h function's
+ * @date 2019
+ */
+
+
+#include "Query.h"
+#include "Search.h"
+#include "Solving.h"
+#include "Z3Tools.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define RETRY_ROUNDS 2			// number of times \ref findPath tries again the lengths it could not decide
+#define RETRY_FACTOR 4			// the time given to each check is multiplied by it at each round
+
+/**
+* @brief findPath find paths by testing formula separatly by depth
+* @param ctx the context of the solver
+* @param options the options of the query
+* @param query the graphs of the query
+* @param statistics increased by what has been done
+* @return Z3_L_TRUE if a length has been found, Z3_L_FALSE if all lengths asked are impossible, Z3_L_UNDEF otherwise
+*/
+Z3_lbool findPath(Z3_context ctx, QueryOptions options, Query query, QueryStatistics *statistics);
+
+/**
+* @brief findPathOfLength decides if all graphs have a simple accepting path of length @p k and displays the answer (the paths found, with the options),
+*        unless it is undecided: \ref findPath tries the length again with more time, and displays it once if it stays undecided
+* @param ctx the context of the solver
+* @param options the options of the query
+* @param query the graphs of the query
+* @param statistics increased by what has been done
+* @param k the length
+* @param previous with -P, the paths of the last length found, replaced by the ones found for @p k
+* @param previousLength the length of @p previous
+* @return the same as \ref solveFormula
+*/
+Z3_lbool findPathOfLength(Z3_context ctx, QueryOptions options, Query query, QueryStatistics *statistics, int k, int ***previous, int *previousLength);
+
+/**
+* @brief solveWithHints solves @p formula, the formula of the paths of length @p pathLength, starting from the paths found in some graphs or for another length
+* @param ctx the context of the solver
+* @param formula the formula given by \ref graphsToPathFormula
+* @param graphs the graphs of the formula
+* @param numGraphs number of graphs
+* @param pathLength the length of the paths of @p formula
+* @param found the paths of length @p pathLength found by \ref findSimplePaths (NULL for none, or for none in a graph)
+* @param previous the paths of the previous length solved (NULL if there is none)
+* @param previousLength the length of @p previous
+* @param model filled as by \ref solveFormula
+* @return the same as \ref solveFormula
+*/
+Z3_lbool solveWithHints(Z3_context ctx, Z3_ast formula, Graph *graphs, unsigned int numGraphs, int pathLength, int **found, int **previous, int previousLength, Z3_model *model);
+
+/**
+* @brief findCachedPath finds the smallest common length with \ref findCachedLength, testing the lengths in increasing order, and displays OUI or NON
+* @param ctx the context of the solver
+* @param options the options of the query
+* @param query the graphs of the query, with their caches
+* @param statistics increased by what has been done
+* @return the answer displayed
+*/
+Z3_lbool findCachedPath(Z3_context ctx, QueryOptions options, Query query, QueryStatistics *statistics);
+
+/**
+* @brief findExtremePath finds the longest (or shortest, according to the options) common length with \ref findExtremeLength and displays the paths found
+* @param ctx the context of the solver
+* @param options the options of the query
+* @param query the graphs of the query
+* @return the answer displayed: Z3_L_FALSE only if no common length is proven
+*/
+Z3_lbool findExtremePath(Z3_context ctx, QueryOptions options, Query query);
+
+/**
+* @brief findSearchedPath looks for the paths of each length in increasing order with \ref findSimplePaths, and displays OUI and the first paths found
+* @param options the options of the query
+* @param query the graphs of the query, searched in their reduced graphs
+* @return true if paths have been found, false if the solver is needed
+*/
+bool findSearchedPath(QueryOptions options, Query query);
+
+/**
+* @brief findDynamicPath finds a common length of the graphs when the lengths of some of them have been computed (see \ref computeDynamicLengths), and displays OUI or NON:
+*        the other graphs are solved once with the formula of \ref graphsToLengthsFormula restricted to the lengths of the graphs computed
+* @param ctx the context of the solver
+* @param options the options of the query
+* @param query the graphs of the query, with their lengths
+* @return the answer displayed
+*/
+Z3_lbool findDynamicPath(Z3_context ctx, QueryOptions options, Query query);
+
+/**
+* @brief findLazyPath finds the smallest common length with \ref solvePathLazily, testing the lengths in increasing order, and displays OUI or NON
+* @param ctx the context of the solver
+* @param options the options of the query
+* @param query the graphs of the query
+* @return the answer displayed
+*/
+Z3_lbool findLazyPath(Z3_context ctx, QueryOptions options, Query query);
+
+/**
+* @brief findLengthPath solves once the formula of \ref graphsToLengthsFormula for the lengths asked with -r and displays the paths found
+* @param ctx the context of the solver
+* @param options the options of the query
+* @param query the graphs of the query
+* @return the answer displayed
+*/
+Z3_lbool findLengthPath(Z3_context ctx, QueryOptions options, Query query);
+
+/**
+* @brief findFullPath solves once the formula of all lengths (\ref graphsToFullFormula, or \ref graphsToSharedFormula with -u) and displays OUI or NON
+* @param ctx the context of the solver
+* @param options the options of the query
+* @param query the graphs of the query
+* @return the answer displayed
+*/
+Z3_lbool findFullPath(Z3_context ctx, QueryOptions options, Query query);
+
+/**
+* @brief printSolutionPaths displays and/or writes in a dot file (according to the options) the paths @p paths of length @p pathLength,
+*        found in the reduced graphs (by the solver or by \ref findSimplePaths) and displayed in the original ones.
+* @param options the options of the query
+* @param graphs all graphs
+* @param reduced the graphs in which the paths were found (NULL if @p paths are already in the original graphs)
+* @param numGraphs number of graphs
+* @param pathLength the length of the paths
+* @param paths the paths, freed by this function
+*/
+void printSolutionPaths(QueryOptions options, Graph *graphs, ReducedGraph *reduced, unsigned int numGraphs, int pathLength, int **paths);
+
+/**
+* @brief printSolution displays and/or writes in a dot file (according to the options) the paths of length @p pathLength described by @p model.
+*        The model is decoded only once for both outputs.
+*        The paths are found in the reduced graphs and displayed in the original ones.
+* @param ctx the context of the solver
+* @param options the options of the query
+* @param model the model of a satisfiable formula
+* @param graphs all graphs
+* @param reduced the graphs given to the solver
+* @param numGraphs number of graphs
+* @param pathLength the length of the paths
+*/
+void printSolution(Z3_context ctx, QueryOptions options, Z3_model model, Graph *graphs, ReducedGraph *reduced, unsigned int numGraphs, int pathLength);
+
+
+QueryOptions defaultQueryOptions(void)
+{
+	QueryOptions options;
+	memset(&options, 0, sizeof(QueryOptions));
+	options.costModel = defaultCostModel();
+	return options;
+}
+
+QueryOptions selectQueryEngine(QueryOptions options, Query query, bool verbose, QueryStatistics *statistics)
+{
+	Graph *reducedGraphs = getReducedGraphs(query.reduced, query.numGraphs);
+	statistics->engine = selectEngine(options.costModel, reducedGraphs, query.numGraphs, verbose, &statistics->features);
+	free(reducedGraphs);
+	if(statistics->engine == ENGINE_SEARCH)
+		options.searchBudget = UNLIMITED_BUDGET;
+	if(statistics->engine == ENGINE_DYNAMIC)
+		options.dynamicNodes = MAX_DYNAMIC_NODES;
+	return options;
+}
+
+Z3_lbool answerQuery(Z3_context ctx, QueryOptions options, Query query, QueryStatistics *statistics)
+{
+	if(options.separately)
+		return findPath(ctx, options, query, statistics);
+	if(options.longest || options.shortest)
+		return findExtremePath(ctx, options, query);
+	if(options.lengths != NULL)
+		return findLengthPath(ctx, options, query);
+	if(query.caches != NULL)
+		return findCachedPath(ctx, options, query, statistics);
+	if(query.lengths != NULL)
+		return findDynamicPath(ctx, options, query);
+	if(options.searchBudget > 0 && findSearchedPath(options, query))
+	{
+		statistics->foundBySearch++;
+		return Z3_L_TRUE;
+	}
+	if(options.searchBudget == UNLIMITED_BUDGET)
+	{
+		/* the search without budget fails only if there is no path, unless it was stopped by the deadline */
+		bool stopped = isDeadlinePassed();
+		printf(stopped ? "UNKNOWN\n" : "NON\n");
+		return stopped ? Z3_L_UNDEF : Z3_L_FALSE;
+	}
+	if(options.lazySimplicity)
+		return findLazyPath(ctx, options, query);
+	return findFullPath(ctx, options, query);
+}
+
+Z3_lbool findFullPath(Z3_context ctx, QueryOptions options, Query query)
+{
+	Graph *reducedGraphs = getReducedGraphs(query.reduced, query.numGraphs);
+	Z3_ast fullFormula;
+	if(options.sharedFormula)
+		fullFormula = graphsToSharedFormula(ctx, reducedGraphs, query.numGraphs);
+	else
+		fullFormula = graphsToFullFormula(ctx, reducedGraphs, query.numGraphs);
+	Z3_model model;
+	Z3_lbool isSat = solveFormula(ctx, fullFormula, &model);
+	if(isSat == Z3_L_TRUE)
+	{
+		printf("OUI\n");
+		if(options.printPath || options.writeDotFile)
+			printSolution(ctx, options, model, query.graphs, query.reduced, query.numGraphs, getSolutionLengthFromModel(ctx, model, reducedGraphs));
+	}
+	else
+		printf(isSat == Z3_L_FALSE ? "NON\n" : "UNKNOWN\n");
+	if(model)
+		Z3_model_dec_ref(ctx, model);
+	if(options.printFormula)
+		printf("FULL FORMULA: %s\n", Z3_ast_to_string(ctx, fullFormula));
+	free(reducedGraphs);
+	return isSat;
+}
+
+Z3_lbool findExtremePath(Z3_context ctx, QueryOptions options, Query query)
+{
+	Graph *reducedGraphs = getReducedGraphs(query.reduced, query.numGraphs);
+	Z3_model model;
+	bool proven;
+	int length = findExtremeLength(ctx, reducedGraphs, query.numGraphs, options.lengths, options.numLengths, options.longest, &model, &proven);
+	if(length == -1 && !proven)
+		printf("unknown common length (undecided by the solver).\n");
+	else if(length == -1 && options.lengths != NULL)
+		printf("no simple valide path of common length in %s.\n", options.lengthsSpec);
+	else if(length == -1)
+		printf("no simple valide path of common length.\n");
+	else
+	{
+		if(proven)
+			printf("There is a simple valide path of length %d in all graphs, and no %s one.\n", length, options.longest ? "longer" : "shorter");
+		else
+			printf("There is a simple valide path of length %d in all graphs (a %s one may exist, undecided by the solver).\n", length, options.longest ? "longer" : "shorter");
+		printSolution(ctx, options, model, query.graphs, query.reduced, query.numGraphs, length);
+		Z3_model_dec_ref(ctx, model);
+	}
+	free(reducedGraphs);
+	if(length != -1)
+		return Z3_L_TRUE;
+	return proven ? Z3_L_FALSE : Z3_L_UNDEF;
+}
+
+bool findSearchedPath(QueryOptions options, Query query)
+{
+	Graph *reducedGraphs = getReducedGraphs(query.reduced, query.numGraphs);
+	int maxLength;
+	bool *possible = possibleCommonLengths(reducedGraphs, query.numGraphs, &maxLength);
+	int **paths = NULL;
+	int k;
+	for(k=0; k<=maxLength && paths == NULL; k++)
+	{
+		if(possible[k])
+			paths = findSimplePaths(reducedGraphs, query.numGraphs, k, options.searchBudget, false);
+	}
+	free(possible);
+	free(reducedGraphs);
+	if(paths == NULL)
+		return false;
+	printf("OUI\n");
+	if(options.printPath || options.writeDotFile)
+		printSolutionPaths(options, query.graphs, query.reduced, query.numGraphs, k-1, paths);
+	else
+		deletePaths(paths, query.numGraphs);
+	return true;
+}
+
+Z3_lbool findDynamicPath(Z3_context ctx, QueryOptions options, Query query)
+{
+	Graph *reducedGraphs = getReducedGraphs(query.reduced, query.numGraphs);
+	int maxLength;
+	bool *possible = possibleCommonLengths(reducedGraphs, query.numGraphs, &maxLength);
+	restrictToDynamicLengths(possible, maxLength, query.lengths, query.numGraphs);
+	free(reducedGraphs);
+	ReducedGraph solved[query.numGraphs];
+	unsigned int numSolved = 0;
+	for(unsigned int i=0; i<query.numGraphs; i++)
+	{
+		if(query.lengths[i].lengths == NULL)
+			solved[numSolved++] = query.reduced[i];
+	}
+
+	/* without any other graph, the smallest length left is the answer */
+	int length = -1;
+	for(int k=0; k<=maxLength && length == -1; k++)
+	{
+		if(possible[k])
+			length = k;
+	}
+	int **found = NULL;
+	Z3_lbool isSat = length == -1 ? Z3_L_FALSE : Z3_L_TRUE;
+	if(numSolved > 0 && length != -1 && isDeadlinePassed())
+		isSat = Z3_L_UNDEF;
+	else if(numSolved > 0 && length != -1)
+	{
+		Graph *solvedGraphs = getReducedGraphs(solved, numSolved);
+		Z3_ast formula = graphsToLengthsFormula(ctx, solvedGraphs, numSolved, possible, maxLength+1);
+		Z3_model model;
+		isSat = solveFormula(ctx, formula, &model);
+		if(isSat == Z3_L_TRUE)
+		{
+			length = getSolutionLengthFromModel(ctx, model, solvedGraphs);
+			found = getPathsFromModel(ctx, model, solvedGraphs, numSolved, length);
+		}
+		if(model)
+			Z3_model_dec_ref(ctx, model);
+		if(options.printFormula)
+			printf("FULL FORMULA: %s\n", Z3_ast_to_string(ctx, formula));
+		free(solvedGraphs);
+	}
+	free(possible);
+	if(isSat != Z3_L_TRUE)
+	{
+		printf(isSat == Z3_L_FALSE ? "NON\n" : "UNKNOWN\n");
+		return isSat;
+	}
+	printf("OUI\n");
+	if(options.printPath || options.writeDotFile)
+		printSolutionPaths(options, query.graphs, query.reduced, query.numGraphs, length, completePaths(query.reduced, query.lengths, query.numGraphs, length, found));
+	else if(found != NULL)
+		deletePaths(found, numSolved);
+	return isSat;
+}
+
+Z3_lbool findLazyPath(Z3_context ctx, QueryOptions options, Query query)
+{
+	Graph *reducedGraphs = getReducedGraphs(query.reduced, query.numGraphs);
+	int maxLength;
+	bool *possible = possibleCommonLengths(reducedGraphs, query.numGraphs, &maxLength);
+	Z3_model model = 0;
+	Z3_lbool isSat = Z3_L_FALSE;
+	bool undecided = false;	// a length not decided in the time given makes NON unproven
+	int k;
+	for(k=0; k<=maxLength && isSat != Z3_L_TRUE; k++)
+	{
+		if(possible[k])
+			isSat = solvePathLazily(ctx, reducedGraphs, query.numGraphs, k, &model);
+		undecided = undecided || (possible[k] && isSat == Z3_L_UNDEF);
+	}
+	free(possible);
+	if(isSat == Z3_L_TRUE)
+	{
+		printf("OUI\n");
+		printSolution(ctx, options, model, query.graphs, query.reduced, query.numGraphs, k-1);
+		Z3_model_dec_ref(ctx, model);
+	}
+	else
+		printf(undecided ? "UNKNOWN\n" : "NON\n");
+	free(reducedGraphs);
+	if(isSat == Z3_L_TRUE)
+		return Z3_L_TRUE;
+	return undecided ? Z3_L_UNDEF : Z3_L_FALSE;
+}
+
+Z3_lbool findLengthPath(Z3_context ctx, QueryOptions options, Query query)
+{
+	Graph *reducedGraphs = getReducedGraphs(query.reduced, query.numGraphs);
+	Z3_ast formula = graphsToLengthsFormula(ctx, reducedGraphs, query.numGraphs, options.lengths, options.numLengths);
+	Z3_model model;
+	Z3_lbool isSat = solveFormula(ctx, formula, &model);
+	if(isSat == Z3_L_TRUE)
+	{
+		int length = getSolutionLengthFromModel(ctx, model, reducedGraphs);
+		printf("There is a simple valide path of length %d in all graphs.\n", length);
+		printSolution(ctx, options, model, query.graphs, query.reduced, query.numGraphs, length);
+	}
+	else if(isSat == Z3_L_FALSE)
+		printf("no simple valide path of common length in %s.\n", options.lengthsSpec);
+	else
+		printf("unknown for lengths %s (undecided by the solver).\n", options.lengthsSpec);
+	if(model)
+		Z3_model_dec_ref(ctx, model);
+	if(options.printFormula)
+		printf("FORMULA FOR LENGTHS %s : %s\n", options.lengthsSpec, Z3_ast_to_string(ctx, formula));
+	free(reducedGraphs);
+	return isSat;
+}
+
+Z3_lbool findPath(Z3_context ctx, QueryOptions options, Query query, QueryStatistics *statistics)
+{
+	Graph *reducedGraphs = getReducedGraphs(query.reduced, query.numGraphs);
+	int maxLength;
+	bool *possible = possibleCommonLengths(reducedGraphs, query.numGraphs, &maxLength);
+	restrictToDynamicLengths(possible, maxLength, query.lengths, query.numGraphs);
+
+	/* the lengths that are not possible (out of the window or of a period) are answered without being solved, up to the order of the smallest graph */
+	int smallest = -1;
+	for(unsigned int i=0; i<query.numGraphs; i++)
+	{
+		if(smallest == -1 || orderG(query.graphs[i]) < smallest)
+			smallest = orderG(query.graphs[i]);
+	}
+	int min_vertices = smallest > maxLength ? smallest : maxLength + 1;
+
+	int **previous = NULL;	// with -P, the paths of the last length found, in the reduced graphs
+	int previousLength = 0;
+	int *unknown = (int *)malloc((maxLength+1)*sizeof(int));	// the lengths the solver could not decide in the time given, in the order tested
+	int numUnknown = 0, numResolved = 0;
+	bool found = false;		// a common length has been found
+
+	int k=0, step = 1;
+	if(options.decreasingOrder)
+	{
+		k=min_vertices-1;
+		step = -1;
+	}
+	int count = 0;
+	while(count <= min_vertices - 1)
+	{
+		bool asked = options.lengths == NULL || (k < options.numLengths && options.lengths[k]);
+		if(asked && (k > maxLength || !possible[k]))
+		{
+			printf("no simple valide path of length %d.\n", k);
+			numResolved++;
+		}
+		else if(asked)
+		{
+			Z3_lbool isSat = findPathOfLength(ctx, options, query, statistics, k, &previous, &previousLength);
+			if(isSat == Z3_L_UNDEF)
+				unknown[numUnknown++] = k;
+			else
+				numResolved++;
+			found = found || isSat == Z3_L_TRUE;
+			if(isSat == Z3_L_TRUE && !options.testAll)
+				break;
+		}
+		k += step;
+		count++;
+	}
+
+	/* the lengths left undecided are tried again with more time, in the same order: without -a, the ones after a length found do not matter anymore */
+	unsigned int timeout = getSolverTimeout();
+	for(int round=0; round<RETRY_ROUNDS && numUnknown > 0 && timeout > 0 && !isDeadlinePassed(); round++)
+	{
+		timeout *= RETRY_FACTOR;
+		setSolverTimeout(timeout);
+		int numLeft = 0;
+		bool stop = false;
+		for(int i=0; i<numUnknown && !stop; i++)
+		{
+			Z3_lbool isSat = findPathOfLength(ctx, options, query, statistics, unknown[i], &previous, &previousLength);
+			if(isSat == Z3_L_UNDEF)
+				unknown[numLeft++] = unknown[i];
+			else
+				numResolved++;
+			found = found || isSat == Z3_L_TRUE;
+			stop = isSat == Z3_L_TRUE && !options.testAll;
+		}
+		numUnknown = numLeft;
+	}
+	setSolverTimeout(options.solverTimeout);
+
+	/* the lengths still undecided after the last round are answered once */
+	for(int i=0; i<numUnknown; i++)
+		printf("unknown for length %d (undecided by the solver).\n", unknown[i]);
+	if(numUnknown > 0 || options.solverTimeout > 0 || options.timeLimit > 0)
+	{
+		printf("lengths resolved: %d, unresolved: %d", numResolved, numUnknown);
+		for(int i=0; i<numUnknown; i++)
+			printf("%s%d", i == 0 ? " (" : ",", unknown[i]);
+		printf("%s\n", numUnknown > 0 ? ")" : "");
+	}
+	statistics->unresolved += numUnknown;
+	if(previous != NULL)
+		deletePaths(previous, query.numGraphs);
+	free(unknown);
+	free(possible);
+	free(reducedGraphs);
+	if(found)
+		return Z3_L_TRUE;
+	return numUnknown > 0 ? Z3_L_UNDEF : Z3_L_FALSE;
+}
+
+Z3_lbool findPathOfLength(Z3_context ctx, QueryOptions options, Query query, QueryStatistics *statistics, int k, int ***previous, int *previousLength)
+{
+	if(query.caches != NULL)
+	{
+		int **paths;
+		Z3_lbool isSat = solveWithCache(ctx, query.reduced, query.caches, query.lengths, query.numGraphs, k, options.searchBudget, &paths, &statistics->foundInCache);
+		if(isSat == Z3_L_TRUE)
+		{
+			printf("There is a simple valide path of length %d in all graphs.\n", k);
+			printSolutionPaths(options, query.graphs, NULL, query.numGraphs, k, paths);
+		}
+		else if(isSat == Z3_L_FALSE)
+			printf("no simple valide path of length %d.\n", k);
+		return isSat;
+	}
+
+	/* the graphs whose lengths are computed have a path of length k (the other lengths are not tried, see \ref findPath): only the other ones are searched or solved */
+	ReducedGraph solved[query.numGraphs];
+	int *solvedPrevious[query.numGraphs];
+	unsigned int numSolved = 0;
+	for(unsigned int i=0; i<query.numGraphs; i++)
+	{
+		if(query.lengths != NULL && query.lengths[i].lengths != NULL)
+			continue;
+		solved[numSolved] = query.reduced[i];
+		solvedPrevious[numSolved++] = *previous != NULL ? (*previous)[i] : NULL;
+	}
+	if(numSolved == 0)
+	{
+		printf("There is a simple valide path of length %d in all graphs.\n", k);
+		if(options.printPath || options.writeDotFile)
+			printSolutionPaths(options, query.graphs, query.reduced, query.numGraphs, k, completePaths(query.reduced, query.lengths, query.numGraphs, k, NULL));
+		return Z3_L_TRUE;
+	}
+
+	Graph *reducedGraphs = getReducedGraphs(solved, numSolved);
+	int **paths = options.searchBudget > 0 ? findSimplePaths(reducedGraphs, numSolved, k, options.searchBudget, options.seedPhases) : NULL;
+	int **found = NULL;
+	for(unsigned int i=0; i<numSolved && paths != NULL && found == NULL; i++)
+	{
+		if(paths[i] == NULL)
+		{
+			found = paths;
+			paths = NULL;
+		}
+	}
+	if(found != NULL && options.searchBudget == UNLIMITED_BUDGET)
+	{
+		/* the search without budget fails only if there is no path, unless it was stopped by the deadline */
+		deletePaths(found, numSolved);
+		found = NULL;
+	}
+	if(paths == NULL && options.searchBudget == UNLIMITED_BUDGET && !isDeadlinePassed())
+	{
+		printf("no simple valide path of length %d.\n", k);
+		free(reducedGraphs);
+		return Z3_L_FALSE;
+	}
+	if(paths != NULL)
+	{
+		statistics->foundBySearch++;
+		printf("There is a simple valide path of length %d in all graphs.\n", k);
+		if(options.printPath || options.writeDotFile)
+			printSolutionPaths(options, query.graphs, query.reduced, query.numGraphs, k, completePaths(query.reduced, query.lengths, query.numGraphs, k, paths));
+		else
+			deletePaths(paths, numSolved);
+		free(reducedGraphs);
+		return Z3_L_TRUE;
+	}
+	/* after the deadline, the formula is not even built */
+	if(isDeadlinePassed())
+	{
+		if(found != NULL)
+			deletePaths(found, numSolved);
+		free(reducedGraphs);
+		return Z3_L_UNDEF;
+	}
+	Z3_ast formula;
+	Z3_model model;
+	Z3_lbool isSat;
+	if(options.lazySimplicity)
+	{
+		formula = NULL;
+		isSat = solvePathLazily(ctx, reducedGraphs, numSolved, k, &model);
+	}
+	else
+	{
+		formula = graphsToPathFormula(ctx, reducedGraphs, numSolved, k);
+		if(options.seedPhases)
+			isSat = solveWithHints(ctx, formula, reducedGraphs, numSolved, k, found, *previous != NULL ? solvedPrevious : NULL, *previousLength, &model);
+		else
+			isSat = solveFormula(ctx, formula, &model);
+	}
+	if(found != NULL)
+		deletePaths(found, numSolved);
+	if(isSat == Z3_L_TRUE)
+	{
+		printf("There is a simple valide path of length %d in all graphs.\n", k);
+		if(options.printPath || options.writeDotFile)
+			printSolutionPaths(options, query.graphs, query.reduced, query.numGraphs, k, completePaths(query.reduced, query.lengths, query.numGraphs, k, getPathsFromModel(ctx, model, reducedGraphs, numSolved, k)));
+		if(options.seedPhases)
+		{
+			if(*previous != NULL)
+				deletePaths(*previous, query.numGraphs);
+			*previous = completePaths(query.reduced, query.lengths, query.numGraphs, k, getPathsFromModel(ctx, model, reducedGraphs, numSolved, k));
+			*previousLength = k;
+		}
+		if(options.printFormula && formula != NULL)
+			printf("FORMULA FOR PATH OF LENGHT %d : %s\n", k, Z3_ast_to_string(ctx, formula));
+	}
+	else if(isSat == Z3_L_FALSE)
+		printf("no simple valide path of length %d.\n", k);
+	if(model)
+		Z3_model_dec_ref(ctx, model);
+	free(reducedGraphs);
+	return isSat;
+}
+
+Z3_lbool solveWithHints(Z3_context ctx, Z3_ast formula, Graph *graphs, unsigned int numGraphs, int pathLength, int **found, int **previous, int previousLength, Z3_model *model)
+{
+	/* in each graph, the path found by the search is the best hint, and the path of the previous length the next best one */
+	Z3_ast *hints = (Z3_ast *)malloc(numGraphs*(pathLength+1)*sizeof(Z3_ast));
+	unsigned int numHints = 0;
+	for(unsigned int i=0; i<numGraphs; i++)
+	{
+		if(found != NULL && found[i] != NULL)
+			numHints += getPathHints(ctx, graphs[i], i, pathLength, found[i], pathLength, hints+numHints);
+		else if(previous != NULL)
+			numHints += getPathHints(ctx, graphs[i], i, pathLength, previous[i], previousLength, hints+numHints);
+	}
+	Z3_lbool isSat = solveFormulaWithHints(ctx, formula, hints, numHints, model);
+	free(hints);
+	return isSat;
+}
+
+Z3_lbool findCachedPath(Z3_context ctx, QueryOptions options, Query query, QueryStatistics *statistics)
+{
+	int length;
+	int **paths;
+	Z3_lbool isSat = findCachedLength(ctx, query.reduced, query.caches, query.lengths, query.numGraphs, options.searchBudget, &length, &paths, &statistics->foundInCache);
+	if(isSat != Z3_L_TRUE)
+	{
+		printf(isSat == Z3_L_FALSE ? "NON\n" : "UNKNOWN\n");
+		return isSat;
+	}
+	printf("OUI\n");
+	printSolutionPaths(options, query.graphs, NULL, query.numGraphs, length, paths);
+	return isSat;
+}
+
+void printSolution(Z3_context ctx, QueryOptions options, Z3_model model, Graph *graphs, ReducedGraph *reduced, unsigned int numGraphs, int pathLength)
+{
+	if(!options.printPath && !options.writeDotFile)
+		return;
+	Graph *reducedGraphs = getReducedGraphs(reduced, numGraphs);
+	int **paths = getPathsFromModel(ctx, model, reducedGraphs, numGraphs, pathLength);
+	free(reducedGraphs);
+	printSolutionPaths(options, graphs, reduced, numGraphs, pathLength, paths);
+}
+
+void printSolutionPaths(QueryOptions options, Graph *graphs, ReducedGraph *reduced, unsigned int numGraphs, int pathLength, int **paths)
+{
+	if(reduced != NULL)
+		liftPaths(reduced, numGraphs, pathLength, paths);
+	if(options.printPath)
+		printPaths(graphs, numGraphs, pathLength, paths);
+	if(options.writeDotFile){
+		char *name = options.dotFileName;
+		if(name == NULL){
+			mkdir("sol", 0755);
+			name = (char *)"sol/result";
+		}
+		createDotFromPaths(graphs, numGraphs, pathLength, paths, name);
+	}
+	deletePaths(paths, numGraphs);
+}
@@ -0,0 +1,859 @@
+/**
+ * @file Search.c
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief An implementation of \ref Search.h function's
+ * @date 2019
+ */
+
+
+#include "Search.h"
+#include "Preprocessing.h"
+#include "Solving.h"
+#include "Z3Tools.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+/**
+* @brief findNode gives the source or the target of a graph
+* @param graph the graph
+* @param source true for the source, false for the target
+* @return the node, orderG(graph) if there is none
+*/
+static int findNode(Graph graph, bool source);
+
+/**
+* @brief sharesOtherNode tells if two sets of nodes have a node in common other than @p node
+* @param first the first set, of @p numWords words (the node i being the bit i)
+* @param second the second set
+* @param numWords the number of words of the sets
+* @param node the node which may be in both sets
+* @return true if another node is in both sets
+*/
+static bool sharesOtherNode(const unsigned long long *first, const unsigned long long *second, int numWords, int node);
+
+#define WORD_BITS			64						// the sets of nodes of \ref findMeetingPath are bits of unsigned long long words
+#define NO_PATH				ULONG_MAX				// no partial path, for \ref PartialPaths
+#define INITIAL_CAPACITY	1024					// the size of the hash table of \ref PartialPaths when the first partial path is added
+#define HASH_MULTIPLIER		0x9E3779B97F4A7C15ULL	// mixes the words of a set of nodes, its last node and its length
+
+/**
+* @brief The partial paths followed by \ref findMeetingPath on one side, one per last node, length and set of nodes: the partial paths which share them
+*        are extended the same way, so only the first one is followed.
+*/
+typedef struct {
+	int numWords;				///< The number of words of a set of nodes.
+	unsigned long numPaths;		///< The number of partial paths.
+	unsigned long capacity;		///< The size of table, a power of 2: the other arrays have half its size.
+	int *last;					///< last[p] is the last node of the partial path p.
+	int *length;				///< length[p] is its length.
+	unsigned long long *nodes;	///< Its set of nodes: the words nodes[p*numWords] to nodes[(p+1)*numWords-1].
+	unsigned long *parent;		///< parent[p] is the partial path it extends by its last node (NO_PATH for the first one).
+	unsigned long *next;		///< next[p] is the next partial path of its list of halves (see \ref findMeetingPath).
+	unsigned long *table;		///< The hash table: 0 for an empty slot, p+1 for the partial path p.
+} PartialPaths;
+
+/**
+* @brief makePartialPaths creates an empty set of partial paths
+* @param numWords the number of words of their sets of nodes
+* @return the set, to free with \ref deletePartialPaths
+*/
+static PartialPaths makePartialPaths(int numWords);
+
+/**
+* @brief hashPartialPath gives the hash of a partial path
+* @param last its last node
+* @param length its length
+* @param nodes its set of nodes
+* @param numWords the number of words of @p nodes
+* @return the hash
+*/
+static unsigned long hashPartialPath(int last, int length, const unsigned long long *nodes, int numWords);
+
+/**
+* @brief insertPartialPath puts a partial path in the hash table of @p paths, which must have a free slot
+* @param paths the partial paths
+* @param path the partial path
+*/
+static void insertPartialPath(PartialPaths *paths, unsigned long path);
+
+/**
+* @brief findPartialPath looks for a partial path
+* @param paths the partial paths
+* @param last its last node
+* @param length its length
+* @param nodes its set of nodes
+* @return the partial path, paths->numPaths if it has not been added
+*/
+static unsigned long findPartialPath(PartialPaths *paths, int last, int length, const unsigned long long *nodes);
+
+/**
+* @brief addPartialPath adds a partial path, growing the arrays and the hash table when they are half full
+* @param paths the partial paths
+* @param last its last node
+* @param length its length
+* @param nodes its set of nodes
+* @param parent the partial path it extends (NO_PATH if there is none)
+* @return the new partial path
+*/
+static unsigned long addPartialPath(PartialPaths *paths, int last, int length, const unsigned long long *nodes, unsigned long parent);
+
+/**
+* @brief deletePartialPaths frees the memory used by a set of partial paths
+* @param paths the partial paths
+*/
+static void deletePartialPaths(PartialPaths paths);
+
+#define STEAL_INTERVAL		1024					// the number of nodes a thread of \ref findParallelPath expands between two looks at the others
+#define DEADLINE_INTERVAL	4096					// the number of steps of a search between two looks at the deadline of \ref setSolverDeadline
+
+/**
+* @brief A branch of the search of \ref findParallelPath left to explore: the subtree of the paths starting with its nodes.
+*/
+typedef struct {
+	int *nodes;			///< The nodes of the branch, from the source.
+	int numNodes;		///< The number of nodes of the branch.
+} SearchTask;
+
+/**
+* @brief The tasks and the state shared by the threads of \ref findParallelPath. Each thread takes the tasks of its own queue from its end (the deepest
+*        branches, which it has just given), and steals the ones of the others from their start (the shallowest, which are the largest subtrees).
+*/
+typedef struct {
+	Graph graph;				///< The graph searched.
+	int pathLength;				///< The length of the path.
+	int target;					///< The target of the graph.
+	int *distance;				///< distance[node] is the distance from node to the target (-1 if it cannot reach it).
+	int numThreads;				///< The number of threads.
+	SearchTask **tasks;			///< tasks[t][firstTask[t]] to tasks[t][lastTask[t]-1] are the tasks of the queue of the thread t.
+	int *firstTask;				///< The first task of each queue.
+	int *lastTask;				///< The end of each queue.
+	int *capacities;			///< The size of each queue.
+	int idle;					///< The number of threads waiting for a task.
+	unsigned long expanded;		///< The number of nodes expanded by all threads, as they last told it.
+	unsigned long budget;		///< The greatest number of nodes expanded.
+	bool stop;					///< true once a path is found, the budget exhausted, or every thread is idle.
+	bool found;					///< true once a path is found.
+	int *path;					///< Filled with the path found.
+	pthread_mutex_t lock;		///< Protects all the fields which change.
+	pthread_cond_t wakeUp;		///< Signaled when tasks are given or when the search stops.
+} SearchPool;
+
+/**
+* @brief A thread of \ref findParallelPath.
+*/
+typedef struct {
+	SearchPool *pool;	///< The pool shared with the others.
+	int index;			///< Its queue in the pool.
+} SearchWorker;
+
+/**
+* @brief pushTask adds a task at the end of the queue of a thread (the lock of @p pool must be held)
+* @param pool the pool
+* @param thread the thread
+* @param nodes the nodes of the branch, copied
+* @param numNodes their number
+*/
+static void pushTask(SearchPool *pool, int thread, const int *nodes, int numNodes);
+
+/**
+* @brief takeTask removes the last task of the queue of a thread, or else the first task of another queue (the lock of @p pool must be held)
+* @param pool the pool
+* @param thread the thread
+* @param task filled with the task, whose nodes are to free
+* @return false if all queues are empty
+*/
+static bool takeTask(SearchPool *pool, int thread, SearchTask *task);
+
+/**
+* @brief searchTask runs the depth-first search of \ref findSimplePath below the branch of a task. Every \ref STEAL_INTERVAL nodes expanded, it tells them
+*        to the pool, stops if the search is over (or the deadline passed), and gives the untried successors of its shallowest node to its queue if a thread is idle and the queue empty.
+* @param worker the thread
+* @param task the task
+* @param stack, positions, next, onBranch the arrays of the search, of the size of the graph (onBranch all false)
+*/
+static void searchTask(SearchWorker *worker, SearchTask task, int *stack, int *positions, int *next, bool *onBranch);
+
+/**
+* @brief searchTasks runs the tasks of a pool, taking or stealing them, until the search stops
+* @param worker the \ref SearchWorker of the thread
+* @return NULL
+*/
+static void *searchTasks(void *worker);
+
+static bool bidirectionalSearch = false;	// true if \ref findSimplePaths uses \ref findMeetingPath
+static int searchThreads = 1;				// the number of threads of \ref findParallelPath used by \ref findSimplePaths
+
+
+static int findNode(Graph graph, bool source)
+{
+	int node;
+	for(node=0; node<orderG(graph) && !(source ? isSource(graph, node) : isTarget(graph, node)); node++);
+	return node;
+}
+
+static bool sharesOtherNode(const unsigned long long *first, const unsigned long long *second, int numWords, int node)
+{
+	for(int w=0; w<numWords; w++)
+	{
+		unsigned long long common = first[w] & second[w];
+		if(w == node / WORD_BITS)
+			common &= ~(1ULL << (node % WORD_BITS));
+		if(common != 0)
+			return true;
+	}
+	return false;
+}
+
+static PartialPaths makePartialPaths(int numWords)
+{
+	PartialPaths paths;
+	paths.numWords = numWords;
+	paths.numPaths = 0;
+	paths.capacity = 0;
+	paths.last = NULL;
+	paths.length = NULL;
+	paths.nodes = NULL;
+	paths.parent = NULL;
+	paths.next = NULL;
+	paths.table = NULL;
+	return paths;
+}
+
+static unsigned long hashPartialPath(int last, int length, const unsigned long long *nodes, int numWords)
+{
+	unsigned long long hash = (unsigned long long)last * HASH_MULTIPLIER + length;
+	for(int w=0; w<numWords; w++)
+		hash = (hash ^ nodes[w]) * HASH_MULTIPLIER;
+	return (unsigned long)(hash ^ (hash >> 29));
+}
+
+static void insertPartialPath(PartialPaths *paths, unsigned long path)
+{
+	unsigned long slot = hashPartialPath(paths->last[path], paths->length[path], paths->nodes + path*paths->numWords, paths->numWords) & (paths->capacity - 1);
+	while(paths->table[slot] != 0)
+		slot = (slot + 1) & (paths->capacity - 1);
+	paths->table[slot] = path + 1;
+}
+
+static unsigned long findPartialPath(PartialPaths *paths, int last, int length, const unsigned long long *nodes)
+{
+	if(paths->capacity == 0)
+		return paths->numPaths;
+	unsigned long slot = hashPartialPath(last, length, nodes, paths->numWords) & (paths->capacity - 1);
+	while(paths->table[slot] != 0)
+	{
+		unsigned long path = paths->table[slot] - 1;
+		if(paths->last[path] == last && paths->length[path] == length && memcmp(paths->nodes + path*paths->numWords, nodes, paths->numWords*sizeof(unsigned long long)) == 0)
+			return path;
+		slot = (slot + 1) & (paths->capacity - 1);
+	}
+	return paths->numPaths;
+}
+
+static unsigned long addPartialPath(PartialPaths *paths, int last, int length, const unsigned long long *nodes, unsigned long parent)
+{
+	if(2*(paths->numPaths + 1) > paths->capacity)
+	{
+		paths->capacity = paths->capacity == 0 ? INITIAL_CAPACITY : 2*paths->capacity;
+		paths->last = (int *)realloc(paths->last, paths->capacity/2*sizeof(int));
+		paths->length = (int *)realloc(paths->length, paths->capacity/2*sizeof(int));
+		paths->nodes = (unsigned long long *)realloc(paths->nodes, paths->capacity/2*paths->numWords*sizeof(unsigned long long));
+		paths->parent = (unsigned long *)realloc(paths->parent, paths->capacity/2*sizeof(unsigned long));
+		paths->next = (unsigned long *)realloc(paths->next, paths->capacity/2*sizeof(unsigned long));
+		free(paths->table);
+		paths->table = (unsigned long *)calloc(paths->capacity, sizeof(unsigned long));
+		for(unsigned long path=0; path<paths->numPaths; path++)
+			insertPartialPath(paths, path);
+	}
+	unsigned long path = paths->numPaths++;
+	paths->last[path] = last;
+	paths->length[path] = length;
+	memcpy(paths->nodes + path*paths->numWords, nodes, paths->numWords*sizeof(unsigned long long));
+	paths->parent[path] = parent;
+	paths->next[path] = NO_PATH;
+	insertPartialPath(paths, path);
+	return path;
+}
+
+static void deletePartialPaths(PartialPaths paths)
+{
+	free(paths.last);
+	free(paths.length);
+	free(paths.nodes);
+	free(paths.parent);
+	free(paths.next);
+	free(paths.table);
+}
+
+bool findSimplePath(Graph graph, int pathLength, unsigned long budget, int *path)
+{
+	int order = orderG(graph);
+	int source = findNode(graph, true);
+	int target = findNode(graph, false);
+	if(source == order || target == order)
+		return false;
+
+	int *distance = (int *)malloc(order*sizeof(int));
+	shortestDistances(graph, target, false, distance);
+
+	/*
+	* stack[depth] is the node at depth depth of the current branch, at position positions[depth], and next[depth] the index of the next successor
+	* of this node to try. onBranch[node] is true if node is on the current branch.
+	*/
+	int *stack = (int *)malloc((order+1)*sizeof(int));
+	int *positions = (int *)malloc((order+1)*sizeof(int));
+	int *next = (int *)malloc((order+1)*sizeof(int));
+	bool *onBranch = (bool *)calloc(order, sizeof(bool));
+	bool found = false;
+
+	int depth = 0;
+	if(distance[source] != -1 && distance[source] <= pathLength)
+	{
+		stack[0] = source;
+		positions[0] = 0;
+		next[0] = 0;
+		onBranch[source] = true;
+	}
+	else
+		depth = -1;
+	unsigned long expanded = 0, steps = 0;
+	while(depth >= 0 && !found && expanded < budget)
+	{
+		if(++steps % DEADLINE_INTERVAL == 0 && isDeadlinePassed())
+			break;
+		int node = stack[depth];
+		if(node == target)
+		{
+			found = positions[depth] == pathLength;
+			if(!found)
+			{
+				onBranch[node] = false;
+				depth--;
+			}
+			continue;
+		}
+		if(next[depth] == 0)
+			expanded++;
+
+		/* the next successor which can still reach the target with the length left */
+		int *successors = getSuccessors(graph, node);
+		int child = -1, childPosition = 0;
+		while(next[depth] < numSuccessors(graph, node) && child == -1)
+		{
+			int successor = successors[next[depth]];
+			int position = positions[depth] + successorWeight(graph, node, next[depth]);
+			next[depth]++;
+			if(!onBranch[successor] && distance[successor] != -1 && position + distance[successor] <= pathLength)
+			{
+				child = successor;
+				childPosition = position;
+			}
+		}
+		if(child == -1)
+		{
+			onBranch[node] = false;
+			depth--;
+			continue;
+		}
+		depth++;
+		stack[depth] = child;
+		positions[depth] = childPosition;
+		next[depth] = 0;
+		onBranch[child] = true;
+	}
+
+	if(found)
+	{
+		for(int pos=0; pos<=pathLength; pos++)
+			path[pos] = -1;
+		for(int i=0; i<=depth; i++)
+			path[positions[i]] = stack[i];
+	}
+	free(distance);
+	free(stack);
+	free(positions);
+	free(next);
+	free(onBranch);
+	return found;
+}
+
+bool findMeetingPath(Graph graph, int pathLength, unsigned long budget, int *path)
+{
+	int order = orderG(graph);
+	int source = findNode(graph, true);
+	int target = findNode(graph, false);
+	if(source == order || target == order)
+		return false;
+
+	int forwardLength = pathLength / 2;
+	int backwardLength = pathLength - forwardLength;
+	int maxWeight = 1;
+	for(int node=0; node<order; node++)
+	{
+		for(int i=0; i<numSuccessors(graph, node); i++)
+		{
+			if(successorWeight(graph, node, i) > maxWeight)
+				maxWeight = successorWeight(graph, node, i);
+		}
+	}
+	int numWords = order / WORD_BITS + 1;
+	int *toTarget = (int *)malloc(order*sizeof(int));
+	int *fromSource = (int *)malloc(order*sizeof(int));
+	shortestDistances(graph, target, false, toTarget);
+	shortestDistances(graph, source, true, fromSource);
+
+	/*
+	* the partial paths followed from the target through the predecessors are the states of backward: the branch of the search is the states stack[0]
+	* to stack[depth], the one of stack[i] being the one of stack[i-1] extended by its last node. A branch stops at the first node where its length
+	* reaches backwardLength, and its state is then a half: the halves ending at the node u with the length backwardLength + d are listed from
+	* heads[u*maxWeight + d] through backward.next. The partial paths from the source are the states of forward, searched the same way.
+	*/
+	PartialPaths backward = makePartialPaths(numWords);
+	PartialPaths forward = makePartialPaths(numWords);
+	unsigned long *heads = (unsigned long *)malloc(order*maxWeight*sizeof(unsigned long));
+	for(int i=0; i<order*maxWeight; i++)
+		heads[i] = NO_PATH;
+	unsigned long *stack = (unsigned long *)malloc((order+1)*sizeof(unsigned long));
+	int *next = (int *)malloc((order+1)*sizeof(int));
+	unsigned long long *branchNodes = (unsigned long long *)calloc(numWords, sizeof(unsigned long long));
+
+	int depth = -1;
+	if(toTarget[source] != -1 && toTarget[source] <= pathLength)
+	{
+		branchNodes[target / WORD_BITS] |= 1ULL << (target % WORD_BITS);
+		stack[0] = addPartialPath(&backward, target, 0, branchNodes, NO_PATH);
+		next[0] = 0;
+		depth = 0;
+	}
+	unsigned long steps = 0;
+	while(depth >= 0 && backward.numPaths + forward.numPaths < budget)
+	{
+		if(++steps % DEADLINE_INTERVAL == 0 && isDeadlinePassed())
+			break;
+		unsigned long state = stack[depth];
+		int node = backward.last[state];
+		if(backward.length[state] >= backwardLength && next[depth] == 0)
+		{
+			/* a half: listed, and not followed further */
+			unsigned long *head = &heads[node*maxWeight + backward.length[state] - backwardLength];
+			backward.next[state] = *head;
+			*head = state;
+			next[depth] = numPredecessors(graph, node);
+		}
+
+		/* the next predecessor from which the source is not too far, if the branch extended by it has not been followed yet */
+		int *predecessors = getPredecessors(graph, node);
+		unsigned long child = NO_PATH;
+		while(next[depth] < numPredecessors(graph, node) && child == NO_PATH)
+		{
+			int predecessor = predecessors[next[depth]];
+			int length = backward.length[state] + edgeWeight(graph, predecessor, node);
+			unsigned long long bit = 1ULL << (predecessor % WORD_BITS);
+			next[depth]++;
+			if((branchNodes[predecessor / WORD_BITS] & bit) || fromSource[predecessor] == -1 || length + fromSource[predecessor] > pathLength)
+				continue;
+			branchNodes[predecessor / WORD_BITS] |= bit;
+			if(findPartialPath(&backward, predecessor, length, branchNodes) == backward.numPaths)
+				child = addPartialPath(&backward, predecessor, length, branchNodes, state);
+			else
+				branchNodes[predecessor / WORD_BITS] &= ~bit;
+		}
+		if(child == NO_PATH)
+		{
+			branchNodes[node / WORD_BITS] &= ~(1ULL << (node % WORD_BITS));
+			depth--;
+			continue;
+		}
+		depth++;
+		stack[depth] = child;
+		next[depth] = 0;
+	}
+
+	/* the search from the source, up to forwardLength, looks at each node for a half with the length left and no other node of its branch */
+	unsigned long meeting = NO_PATH;
+	bool complete = depth < 0;
+	depth = -1;
+	if(complete && backward.numPaths > 0)
+	{
+		branchNodes[source / WORD_BITS] |= 1ULL << (source % WORD_BITS);
+		stack[0] = addPartialPath(&forward, source, 0, branchNodes, NO_PATH);
+		next[0] = 0;
+		depth = 0;
+	}
+	while(depth >= 0 && meeting == NO_PATH && backward.numPaths + forward.numPaths < budget)
+	{
+		if(++steps % DEADLINE_INTERVAL == 0 && isDeadlinePassed())
+			break;
+		unsigned long state = stack[depth];
+		int node = forward.last[state];
+		int left = pathLength - forward.length[state];
+		if(next[depth] == 0 && left >= backwardLength && left < backwardLength + maxWeight)
+		{
+			for(unsigned long half = heads[node*maxWeight + left - backwardLength]; half != NO_PATH && meeting == NO_PATH; half = backward.next[half])
+			{
+				if(!sharesOtherNode(branchNodes, backward.nodes + half*numWords, numWords, node))
+					meeting = half;
+			}
+			if(meeting != NO_PATH)
+				continue;
+		}
+
+		int *successors = getSuccessors(graph, node);
+		unsigned long child = NO_PATH;
+		while(next[depth] < numSuccessors(graph, node) && child == NO_PATH)
+		{
+			int successor = successors[next[depth]];
+			int position = forward.length[state] + successorWeight(graph, node, next[depth]);
+			unsigned long long bit = 1ULL << (successor % WORD_BITS);
+			next[depth]++;
+			if(successor == target || (branchNodes[successor / WORD_BITS] & bit) || position > forwardLength || toTarget[successor] == -1 || position + toTarget[successor] > pathLength)
+				continue;
+			branchNodes[successor / WORD_BITS] |= bit;
+			if(findPartialPath(&forward, successor, position, branchNodes) == forward.numPaths)
+				child = addPartialPath(&forward, successor, position, branchNodes, state);
+			else
+				branchNodes[successor / WORD_BITS] &= ~bit;
+		}
+		if(child == NO_PATH)
+		{
+			branchNodes[node / WORD_BITS] &= ~(1ULL << (node % WORD_BITS));
+			depth--;
+			continue;
+		}
+		depth++;
+		stack[depth] = child;
+		next[depth] = 0;
+	}
+
+	if(meeting != NO_PATH)
+	{
+		for(int pos=0; pos<=pathLength; pos++)
+			path[pos] = -1;
+		for(unsigned long state = stack[depth]; state != NO_PATH; state = forward.parent[state])
+			path[forward.length[state]] = forward.last[state];
+		for(unsigned long state = meeting; state != NO_PATH; state = backward.parent[state])
+			path[pathLength - backward.length[state]] = backward.last[state];
+	}
+	free(toTarget);
+	free(fromSource);
+	deletePartialPaths(backward);
+	deletePartialPaths(forward);
+	free(heads);
+	free(stack);
+	free(next);
+	free(branchNodes);
+	return meeting != NO_PATH;
+}
+
+static void pushTask(SearchPool *pool, int thread, const int *nodes, int numNodes)
+{
+	if(pool->lastTask[thread] == pool->capacities[thread])
+	{
+		/* the tasks stolen leave room at the start of the queue, used again before growing it */
+		int numTasks = pool->lastTask[thread] - pool->firstTask[thread];
+		memmove(pool->tasks[thread], pool->tasks[thread] + pool->firstTask[thread], numTasks*sizeof(SearchTask));
+		pool->firstTask[thread] = 0;
+		pool->lastTask[thread] = numTasks;
+		if(2*numTasks > pool->capacities[thread])
+		{
+			pool->capacities[thread] *= 2;
+			pool->tasks[thread] = (SearchTask *)realloc(pool->tasks[thread], pool->capacities[thread]*sizeof(SearchTask));
+		}
+	}
+	SearchTask *task = &pool->tasks[thread][pool->lastTask[thread]++];
+	task->nodes = (int *)malloc(numNodes*sizeof(int));
+	memcpy(task->nodes, nodes, numNodes*sizeof(int));
+	task->numNodes = numNodes;
+}
+
+static bool takeTask(SearchPool *pool, int thread, SearchTask *task)
+{
+	if(pool->lastTask[thread] > pool->firstTask[thread])
+	{
+		*task = pool->tasks[thread][--pool->lastTask[thread]];
+		return true;
+	}
+	for(int i=1; i<pool->numThreads; i++)
+	{
+		int victim = (thread + i) % pool->numThreads;
+		if(pool->lastTask[victim] > pool->firstTask[victim])
+		{
+			*task = pool->tasks[victim][pool->firstTask[victim]++];
+			return true;
+		}
+	}
+	return false;
+}
+
+static void searchTask(SearchWorker *worker, SearchTask task, int *stack, int *positions, int *next, bool *onBranch)
+{
+	SearchPool *pool = worker->pool;
+	Graph graph = pool->graph;
+
+	/* the nodes of the task are the bottom of the stack, with no successor left to try but for the last one, below which the search stops */
+	int base = task.numNodes - 1;
+	for(int depth=0; depth<=base; depth++)
+	{
+		stack[depth] = task.nodes[depth];
+		positions[depth] = depth == 0 ? 0 : positions[depth-1] + edgeWeight(graph, stack[depth-1], stack[depth]);
+		next[depth] = numSuccessors(graph, stack[depth]);
+		onBranch[stack[depth]] = true;
+	}
+	next[base] = 0;
+
+	int depth = base;
+	unsigned long expanded = 0;
+	bool stop = false;
+	while(depth >= base && !stop)
+	{
+		int node = stack[depth];
+		if(node == pool->target)
+		{
+			if(positions[depth] == pool->pathLength)
+			{
+				pthread_mutex_lock(&pool->lock);
+				if(!pool->found)
+				{
+					for(int pos=0; pos<=pool->pathLength; pos++)
+						pool->path[pos] = -1;
+					for(int i=0; i<=depth; i++)
+						pool->path[positions[i]] = stack[i];
+				}
+				pool->found = pool->stop = true;
+				pthread_cond_broadcast(&pool->wakeUp);
+				pthread_mutex_unlock(&pool->lock);
+				stop = true;
+			}
+			onBranch[node] = false;
+			depth--;
+			continue;
+		}
+		if(next[depth] == 0 && ++expanded == STEAL_INTERVAL)
+		{
+			pthread_mutex_lock(&pool->lock);
+			pool->expanded += expanded;
+			expanded = 0;
+			if(pool->expanded >= pool->budget || isDeadlinePassed())
+			{
+				pool->stop = true;
+				pthread_cond_broadcast(&pool->wakeUp);
+			}
+			stop = pool->stop;
+			if(!stop && pool->idle > 0 && pool->lastTask[worker->index] == pool->firstTask[worker->index])
+			{
+				int shallowest;
+				for(shallowest=base; shallowest<depth && next[shallowest] == numSuccessors(graph, stack[shallowest]); shallowest++);
+				int *successors = getSuccessors(graph, stack[shallowest]);
+				int kept = stack[shallowest+1];
+				for(; next[shallowest] < numSuccessors(graph, stack[shallowest]); next[shallowest]++)
+				{
+					int successor = successors[next[shallowest]];
+					int position = positions[shallowest] + successorWeight(graph, stack[shallowest], next[shallowest]);
+					if(onBranch[successor] || pool->distance[successor] == -1 || position + pool->distance[successor] > pool->pathLength)
+						continue;
+					stack[shallowest+1] = successor;
+					pushTask(pool, worker->index, stack, shallowest + 2);
+				}
+				stack[shallowest+1] = kept;
+				pthread_cond_broadcast(&pool->wakeUp);
+			}
+			pthread_mutex_unlock(&pool->lock);
+			if(stop)
+				continue;
+		}
+
+		/* the next successor which can still reach the target with the length left */
+		int *successors = getSuccessors(graph, node);
+		int child = -1, childPosition = 0;
+		while(next[depth] < numSuccessors(graph, node) && child == -1)
+		{
+			int successor = successors[next[depth]];
+			int position = positions[depth] + successorWeight(graph, node, next[depth]);
+			next[depth]++;
+			if(!onBranch[successor] && pool->distance[successor] != -1 && position + pool->distance[successor] <= pool->pathLength)
+			{
+				child = successor;
+				childPosition = position;
+			}
+		}
+		if(child == -1)
+		{
+			onBranch[node] = false;
+			depth--;
+			continue;
+		}
+		depth++;
+		stack[depth] = child;
+		positions[depth] = childPosition;
+		next[depth] = 0;
+		onBranch[child] = true;
+	}
+
+	/* the nodes of the task below base are still on the stack */
+	for(int i=0; i<=depth; i++)
+		onBranch[stack[i]] = false;
+	pthread_mutex_lock(&pool->lock);
+	pool->expanded += expanded;
+	if(pool->expanded >= pool->budget)
+		pool->stop = true;
+	pthread_mutex_unlock(&pool->lock);
+}
+
+static void *searchTasks(void *argument)
+{
+	SearchWorker *worker = (SearchWorker *)argument;
+	SearchPool *pool = worker->pool;
+	int order = orderG(pool->graph);
+	int *stack = (int *)malloc((order+1)*sizeof(int));
+	int *positions = (int *)malloc((order+1)*sizeof(int));
+	int *next = (int *)malloc((order+1)*sizeof(int));
+	bool *onBranch = (bool *)calloc(order, sizeof(bool));
+
+	pthread_mutex_lock(&pool->lock);
+	while(!pool->stop)
+	{
+		SearchTask task;
+		if(!takeTask(pool, worker->index, &task))
+		{
+			/* the search is over when every thread waits: no task is left, and none can be given */
+			pool->idle++;
+			if(pool->idle == pool->numThreads)
+			{
+				pool->stop = true;
+				pthread_cond_broadcast(&pool->wakeUp);
+			}
+			else
+				pthread_cond_wait(&pool->wakeUp, &pool->lock);
+			pool->idle--;
+			continue;
+		}
+		pthread_mutex_unlock(&pool->lock);
+		searchTask(worker, task, stack, positions, next, onBranch);
+		free(task.nodes);
+		pthread_mutex_lock(&pool->lock);
+	}
+	pthread_mutex_unlock(&pool->lock);
+
+	free(stack);
+	free(positions);
+	free(next);
+	free(onBranch);
+	return NULL;
+}
+
+bool findParallelPath(Graph graph, int pathLength, unsigned long budget, int numThreads, int *path)
+{
+	int order = orderG(graph);
+	int source = findNode(graph, true);
+	int target = findNode(graph, false);
+	if(source == order || target == order)
+		return false;
+
+	SearchPool pool;
+	pool.graph = graph;
+	pool.pathLength = pathLength;
+	pool.target = target;
+	pool.distance = (int *)malloc(order*sizeof(int));
+	shortestDistances(graph, target, false, pool.distance);
+	if(pool.distance[source] == -1 || pool.distance[source] > pathLength)
+	{
+		free(pool.distance);
+		return false;
+	}
+	pool.numThreads = numThreads;
+	pool.tasks = (SearchTask **)malloc(numThreads*sizeof(SearchTask *));
+	pool.firstTask = (int *)calloc(numThreads, sizeof(int));
+	pool.lastTask = (int *)calloc(numThreads, sizeof(int));
+	pool.capacities = (int *)malloc(numThreads*sizeof(int));
+	for(int t=0; t<numThreads; t++)
+	{
+		pool.capacities[t] = order + 1;
+		pool.tasks[t] = (SearchTask *)malloc(pool.capacities[t]*sizeof(SearchTask));
+	}
+	pool.idle = 0;
+	pool.expanded = 0;
+	pool.budget = budget;
+	pool.stop = false;
+	pool.found = false;
+	pool.path = path;
+	pthread_mutex_init(&pool.lock, NULL);
+	pthread_cond_init(&pool.wakeUp, NULL);
+
+	/* the whole tree is the task of the first thread, the others stealing the branches it gives */
+	pushTask(&pool, 0, &source, 1);
+	SearchWorker *workers = (SearchWorker *)malloc(numThreads*sizeof(SearchWorker));
+	pthread_t *threads = (pthread_t *)malloc(numThreads*sizeof(pthread_t));
+	for(int t=0; t<numThreads; t++)
+	{
+		workers[t].pool = &pool;
+		workers[t].index = t;
+		if(pthread_create(&threads[t], NULL, searchTasks, &workers[t]) != 0)
+		{
+			fprintf(stderr, "Could not create a thread to search the graph.\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+	for(int t=0; t<numThreads; t++)
+		pthread_join(threads[t], NULL);
+
+	/* the tasks left when a path is found or the budget exhausted */
+	for(int t=0; t<numThreads; t++)
+	{
+		for(int i=pool.firstTask[t]; i<pool.lastTask[t]; i++)
+			free(pool.tasks[t][i].nodes);
+		free(pool.tasks[t]);
+	}
+	free(pool.tasks);
+	free(pool.firstTask);
+	free(pool.lastTask);
+	free(pool.capacities);
+	free(pool.distance);
+	free(workers);
+	free(threads);
+	pthread_mutex_destroy(&pool.lock);
+	pthread_cond_destroy(&pool.wakeUp);
+	return pool.found;
+}
+
+void setBidirectionalSearch(bool bidirectional)
+{
+	bidirectionalSearch = bidirectional;
+}
+
+void setSearchThreads(int numThreads)
+{
+	searchThreads = numThreads;
+}
+
+int **findSimplePaths(Graph *graphs, int numGraphs, int pathLength, unsigned long budget, bool partial)
+{
+	int **paths = (int **)malloc(numGraphs*sizeof(int *));
+	bool found = true;
+	for(int i=0; i<numGraphs; i++)
+	{
+		paths[i] = NULL;
+		if(!found && !partial)
+			continue;
+		paths[i] = (int *)malloc((pathLength+1)*sizeof(int));
+		bool pathFound;
+		if(bidirectionalSearch)
+			pathFound = findMeetingPath(graphs[i], pathLength, budget, paths[i]);
+		else if(searchThreads > 1)
+			pathFound = findParallelPath(graphs[i], pathLength, budget, searchThreads, paths[i]);
+		else
+			pathFound = findSimplePath(graphs[i], pathLength, budget, paths[i]);
+		if(!pathFound)
+		{
+			free(paths[i]);
+			paths[i] = NULL;
+			found = false;
+		}
+	}
+	if(found || partial)
+		return paths;
+	deletePaths(paths, numGraphs);
+	return NULL;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file Selection.c
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief An implementation of \ref Selection.h function's
+ * @date 2019
+ */
+
+
+#include "Selection.h"
+#include "Preprocessing.h"
+#include "Solving.h"
+#include "Dynamic.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define MAX_EXPANSIONS 1e30	// the estimate of the nodes expanded by the search for a length is bounded, the search being hopeless far before
+
+const char *engineNames[NUM_ENGINE_KINDS] = {"solver", "search", "dynamic"};
+
+
+GraphFeatures computeFeatures(Graph *graphs, int numGraphs)
+{
+	GraphFeatures features;
+	features.numGraphs = numGraphs;
+	features.numNodes = 0;
+	features.numEdges = 0;
+	features.density = 0;
+	features.branching = 0;
+	features.largestComponent = 0;
+	features.subsets = 0;
+	for(int i=0; i<numGraphs; i++)
+	{
+		int order = orderG(graphs[i]), size = sizeG(graphs[i]);
+		features.subsets += pow(2, order);
+		if(order > features.numNodes)
+			features.numNodes = order;
+		if(size > features.numEdges)
+			features.numEdges = size;
+		if(order > 1 && (double)size / ((double)order * (order - 1)) > features.density)
+			features.density = (double)size / ((double)order * (order - 1));
+		if(order > 0 && (double)size / order > features.branching)
+			features.branching = (double)size / order;
+
+		int *component = (int *)malloc(order*sizeof(int));
+		int numComponents = stronglyConnectedComponents(graphs[i], component);
+		int *sizes = (int *)calloc(numComponents, sizeof(int));
+		for(int node=0; node<order; node++)
+		{
+			sizes[component[node]]++;
+			if(sizes[component[node]] > features.largestComponent)
+				features.largestComponent = sizes[component[node]];
+		}
+		free(sizes);
+		free(component);
+	}
+
+	/*
+	* each length possible costs the solver its variables, and the search the branches of the graphs up to that length: with b successors per node,
+	* about b^k nodes for the length k, fewer when the graph has no cycle since the branches then end as soon as they cannot reach the target
+	*/
+	int maxLength;
+	bool *possible = possibleCommonLengths(graphs, numGraphs, &maxLength);
+	features.minLength = features.maxLength = -1;
+	features.numLengths = 0;
+	features.variables = 0;
+	features.expansions = 0;
+	double branching = features.largestComponent > 1 ? features.branching : sqrt(features.branching);
+	for(int k=0; k<=maxLength; k++)
+	{
+		if(!possible[k])
+			continue;
+		if(features.minLength == -1)
+			features.minLength = k;
+		features.maxLength = k;
+		features.numLengths++;
+		for(int i=0; i<numGraphs; i++)
+			features.variables += countPathVariables(graphs[i], k);
+		double expansions = branching > 1 ? pow(branching, k) : k + 1;
+		features.expansions += numGraphs * (expansions < MAX_EXPANSIONS ? expansions : MAX_EXPANSIONS);
+	}
+	free(possible);
+	return features;
+}
+
+CostModel defaultCostModel(void)
+{
+	CostModel model;
+	model.solverPerVariable = 1.5e-4;
+	model.solverPerLength = 1e-3;
+	/* the search takes a tenth of a second up to about 1e25 nodes estimated, but more than a minute from 1e31 on (Taille50 and Taille60) */
+	model.searchPerNode = 8.5e-13;
+	model.searchExponent = 0.45;
+	model.searchPerLength = 1e-4;
+	model.dynamicPerState = 1e-6;
+	model.dynamicExponent = 0.65;
+	return model;
+}
+
+CostModel readCostModel(const char *fileName, CostModel model)
+{
+	FILE *file = fopen(fileName, "r");
+	if(file == NULL)
+	{
+		fprintf(stderr, "Cannot read the cost model %s\n", fileName);
+		exit(EXIT_FAILURE);
+	}
+	char line[256];
+	int number = 0;
+	while(fgets(line, sizeof(line), file) != NULL)
+	{
+		number++;
+		char name[256];
+		double value;
+		if(line[0] == '#' || sscanf(line, "%255s", name) != 1)
+			continue;
+		if(sscanf(line, "%255s %lf", name, &value) != 2 || value < 0)
+		{
+			fprintf(stderr, "%s:%d: expected a name and a non-negative number of seconds\n", fileName, number);
+			exit(EXIT_FAILURE);
+		}
+		if(strcmp(name, "solver_per_variable") == 0)
+			model.solverPerVariable = value;
+		else if(strcmp(name, "solver_per_length") == 0)
+			model.solverPerLength = value;
+		else if(strcmp(name, "search_per_node") == 0)
+			model.searchPerNode = value;
+		else if(strcmp(name, "search_exponent") == 0)
+			model.searchExponent = value;
+		else if(strcmp(name, "search_per_length") == 0)
+			model.searchPerLength = value;
+		else if(strcmp(name, "dynamic_per_state") == 0)
+			model.dynamicPerState = value;
+		else if(strcmp(name, "dynamic_exponent") == 0)
+			model.dynamicExponent = value;
+		else
+		{
+			fprintf(stderr, "%s:%d: unknown coefficient %s\n", fileName, number, name);
+			exit(EXIT_FAILURE);
+		}
+	}
+	fclose(file);
+	return model;
+}
+
+double estimateCost(CostModel model, GraphFeatures features, Engine engine)
+{
+	double solver = model.solverPerVariable * features.variables + model.solverPerLength * features.numLengths;
+	if(engine == ENGINE_SEARCH)
+		return model.searchPerNode * pow(features.expansions, model.searchExponent) + model.searchPerLength * features.numLengths;
+	if(engine == ENGINE_DYNAMIC)
+	{
+		double states = pow(features.subsets, model.dynamicExponent);
+		if(states > MAX_DYNAMIC_STATES)
+			return model.dynamicPerState * MAX_DYNAMIC_STATES + solver;
+		return model.dynamicPerState * states;
+	}
+	return solver;
+}
+
+Engine chooseEngine(CostModel model, GraphFeatures features)
+{
+	Engine best = ENGINE_SOLVER;
+	for(int engine=0; engine<NUM_ENGINE_KINDS; engine++)
+	{
+		if(estimateCost(model, features, (Engine)engine) < estimateCost(model, features, best))
+			best = (Engine)engine;
+	}
+	return best;
+}
+
+Engine selectEngine(CostModel model, Graph *graphs, int numGraphs, bool verbose, GraphFeatures *features)
+{
+	*features = computeFeatures(graphs, numGraphs);
+	Engine engine = chooseEngine(model, *features);
+	if(verbose)
+	{
+		printf("engine chosen: %s (estimated:", getEngineName(engine));
+		for(int other=0; other<NUM_ENGINE_KINDS; other++)
+			printf(" %s %.3g s", getEngineName((Engine)other), estimateCost(model, *features, (Engine)other));
+		printf(")\n");
+	}
+	return engine;
+}
+
+const char *getEngineName(Engine engine)
+{
+	return engineNames[engine];
+}
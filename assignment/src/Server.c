@@ -0,0 +1,187 @@
+/**
+ * @file Server.c
+ * @author Bah Elhadj amadou et Abdelamine Mehdaoui
+ * @brief An implementation of \ref Server.h function's
+ * @date 2019
+ */
+
+
+#include "Server.h"
+#include "Parsing.h"
+#include "Z3Tools.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+void serve(Z3_context ctx, QueryOptions options, bool printStats, int loadingThreads, char **fileNames, int numFiles)
+{
+	LoadedGraph *loaded = NULL;
+	int numLoaded = 0;
+	int indices[MAX_QUERY_SIZE/2 + 1];
+	if(numFiles > 0)
+		loadQueryGraphs(&loaded, &numLoaded, fileNames, numFiles, indices, options.cacheDirectory, loadingThreads);
+	printf("READY\n");
+	fflush(stdout);
+
+	/* the graphs of a query are put in these arrays, owned by the loop, since a query has at most as many files as MAX_QUERY_SIZE/2 + 1 */
+	Graph *graphs = (Graph *)malloc((MAX_QUERY_SIZE/2 + 1)*sizeof(Graph));
+	ReducedGraph *reduced = (ReducedGraph *)malloc((MAX_QUERY_SIZE/2 + 1)*sizeof(ReducedGraph));
+	GraphCache *caches = (GraphCache *)malloc((MAX_QUERY_SIZE/2 + 1)*sizeof(GraphCache));
+	PathLengths *lengths = (PathLengths *)malloc((MAX_QUERY_SIZE/2 + 1)*sizeof(PathLengths));
+
+	char line[MAX_QUERY_SIZE];
+	while(fgets(line, MAX_QUERY_SIZE, stdin) != NULL)
+	{
+		char *command = strtok(line, " \t\r\n");
+		if(command == NULL)
+			continue;
+		if(strcmp(command, "quit") == 0)
+			break;
+		char *names[MAX_QUERY_SIZE/2 + 1];
+		int numGraphs = 0;
+		char *name;
+		while((name = strtok(NULL, " \t\r\n")) != NULL)
+			names[numGraphs++] = name;
+
+		clock_t start = clock();
+		unsigned int calls = getNumSolverCalls();
+		setSolverDeadline(options.timeLimit);
+		if(strcmp(command, "first") != 0 && strcmp(command, "all") != 0 && strcmp(command, "witness") != 0)
+			printf("unknown query %s (first, all, witness or quit)\n", command);
+		else if(numGraphs == 0)
+			printf("%s needs at least one file\n", command);
+		else if(loadQueryGraphs(&loaded, &numLoaded, names, numGraphs, indices, options.cacheDirectory, loadingThreads))
+		{
+			for(int i=0; i<numGraphs; i++)
+			{
+				graphs[i] = loaded[indices[i]].graph;
+				reduced[i] = loaded[indices[i]].reduced;
+				caches[i] = loaded[indices[i]].cache;
+			}
+			Query query;
+			query.graphs = graphs;
+			query.reduced = reduced;
+			query.numGraphs = numGraphs;
+			query.caches = options.cacheDirectory != NULL ? caches : NULL;
+			query.lengths = NULL;
+			QueryStatistics statistics;
+			memset(&statistics, 0, sizeof(QueryStatistics));
+			/* each query has its own options, as if they had been given with -s, -a and -t */
+			QueryOptions queryOptions = options;
+			if(options.automaticEngine)
+				queryOptions = selectQueryEngine(options, query, printStats, &statistics);
+			queryOptions.separately = true;
+			queryOptions.testAll = strcmp(command, "all") == 0;
+			queryOptions.printPath = options.printPath || strcmp(command, "witness") == 0;
+			/* the lengths of a graph are computed by the first query asking for them, and kept for the next ones */
+			for(int i=0; i<numGraphs; i++)
+			{
+				LoadedGraph *graph = &loaded[indices[i]];
+				if(!graph->lengthsTried && orderG(graph->reduced.graph) <= queryOptions.dynamicNodes)
+				{
+					computePathLengths(graph->reduced.graph, MAX_DYNAMIC_STATES, &graph->lengths);
+					graph->lengthsTried = true;
+				}
+				lengths[i] = graph->lengths;
+				if(lengths[i].lengths != NULL)
+					query.lengths = lengths;
+			}
+			answerQuery(ctx, queryOptions, query, &statistics);
+			/* the copies share the lengths with the loaded caches, only the ones which learnt something are written, and then kept as loaded */
+			for(int i=0; i<numGraphs && query.caches != NULL; i++)
+			{
+				saveGraphCache(caches[i]);
+				caches[i].modified = false;
+				loaded[indices[i]].cache = caches[i];
+			}
+		}
+		if(printStats)
+			printf("solver calls: %u\ntime: %.3f s\n", getNumSolverCalls() - calls, (double)(clock() - start) / CLOCKS_PER_SEC);
+		printf("END\n");
+		fflush(stdout);
+	}
+
+	for(int i=0; i<numLoaded; i++)
+	{
+		if(options.cacheDirectory != NULL)
+			deleteGraphCache(loaded[i].cache);
+		if(loaded[i].lengths.lengths != NULL)
+			deletePathLengths(loaded[i].lengths);
+		deleteReducedGraph(loaded[i].reduced);
+		deleteGraph(loaded[i].graph);
+		free(loaded[i].fileName);
+	}
+	free(loaded);
+	free(graphs);
+	free(reduced);
+	free(caches);
+	free(lengths);
+}
+
+bool loadQueryGraphs(LoadedGraph **loaded, int *numLoaded, char **names, int numNames, int *indices, char *cacheDirectory, int loadingThreads)
+{
+	struct stat status[numNames];
+	for(int i=0; i<numNames; i++)
+	{
+		if(stat(names[i], &status[i]) != 0)
+		{
+			printf("file %s does not exist.\n", names[i]);
+			return false;
+		}
+	}
+
+	char *toRead[numNames];
+	int numToRead = 0;
+	for(int i=0; i<numNames; i++)
+	{
+		indices[i] = -1;
+		for(int j=0; j<*numLoaded && indices[i] == -1; j++)
+		{
+			if(strcmp((*loaded)[j].fileName, names[i]) == 0)
+				indices[i] = j;
+		}
+		/* a file changed since it was read is read again in place */
+		if(indices[i] != -1 && (*loaded)[indices[i]].modified != status[i].st_mtime)
+		{
+			LoadedGraph *old = &(*loaded)[indices[i]];
+			if(cacheDirectory != NULL)
+				deleteGraphCache(old->cache);
+			if(old->lengths.lengths != NULL)
+				deletePathLengths(old->lengths);
+			deleteReducedGraph(old->reduced);
+			deleteGraph(old->graph);
+			old->modified = status[i].st_mtime;
+			toRead[numToRead++] = old->fileName;
+		}
+		if(indices[i] == -1)
+		{
+			*loaded = (LoadedGraph *)realloc(*loaded, (*numLoaded+1)*sizeof(LoadedGraph));
+			LoadedGraph *added = &(*loaded)[*numLoaded];
+			added->fileName = (char *)malloc(strlen(names[i])+1);
+			strcpy(added->fileName, names[i]);
+			added->modified = status[i].st_mtime;
+			indices[i] = (*numLoaded)++;
+			toRead[numToRead++] = added->fileName;
+		}
+	}
+
+	if(numToRead == 0)
+		return true;
+	Graph graphs[numToRead];
+	getGraphsFromFiles(toRead, numToRead, loadingThreads, graphs);
+	for(int i=0; i<numToRead; i++)
+	{
+		int j = 0;
+		while((*loaded)[j].fileName != toRead[i])
+			j++;
+		(*loaded)[j].graph = graphs[i];
+		(*loaded)[j].reduced = simplifyGraph(graphs[i]);
+		(*loaded)[j].lengths.lengths = NULL;
+		(*loaded)[j].lengthsTried = false;
+		if(cacheDirectory != NULL)
+			(*loaded)[j].cache = loadGraphCache(cacheDirectory, graphs[i]);
+	}
+	return true;
+}
@@ -8,73 +8,92 @@
 
 #include "Solving.h"
 #include "Z3Tools.h"
+#include "Preprocessing.h"
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
 
-#define MAX_ORDER_G			100				// represents the maximum of nodes which can have a graph. In this project it's 90. Increase it if necessary
 #define OPTIMIZE			true// if true formulas will be optimized for the solver (reducing the number of variables in the formulas). \ref optimizeAndMakeFormula
-#define FILE_SIZE			1000
-#define NODE_VARIABLE_SIZE  10 
+#define MANDATORY_NODES		true// if true the nodes through which every accepting path goes are placed in their possible positions by unit facts. \ref makeMandatoryFormula
+#define NODE_VARIABLE_SIZE  64				// enough for "X" followed by four integers separated by commas
+#define ANY_LENGTH			-1				// value of k in the node variables of the formula shared by all lengths \ref graphsToSharedFormula
 
 /**
-*\struct nodePos 
-*\brief represents a node and its position wich is the type of elements in \ref File_t
+* @brief makeOneHotFormula makes the formula of \ref optimizeAndMakeFormula: a variable for each pair (node, position)
+* @param ctx the context of the solver
+* @param graph the graph
+* @param number the graph number
+* @param pathLength the path's length
+* @return a formula satisfiable only if the graph has a simple accepting path of length @p pathLength
 */
-typedef struct nodePos{
-	unsigned int node;
-	unsigned int position;
-}fileElement_t;
+Z3_ast makeOneHotFormula(Z3_context ctx, Graph graph, int number, int pathLength);
 
 /**
-*\struct File_s 
-*\brief represents a file
+* @brief makeSuccessorFormula makes a formula with a variable for each edge telling if it is in the path (see \ref getEdgeVariable) and an integer position
+*        for each node (see \ref getOrderVariable): nodes have at most one chosen edge in and out, and a chosen edge adds its length to the position,
+*        which excludes cycles. The formula has a size linear in the size of the graph whatever the length.
+* @param ctx the context of the solver
+* @param graph the graph
+* @param number the graph number
+* @param pathLength the path's length
+* @return a formula satisfiable only if the graph has a simple accepting path of length @p pathLength
 */
-typedef struct File_s{
-	fileElement_t tab[FILE_SIZE];
-	unsigned int size;
-	unsigned int currentPos;
-}File_t;
+Z3_ast makeSuccessorFormula(Z3_context ctx, Graph graph, int number, int pathLength);
 
 /**
-* @brief isEmpty tests if a file is empty or not
-* @param file is the file to check
-* @return true if the file is empty and False otherwise
+* @brief makeLogFormula makes a formula with, for each position, a bit-vector giving in binary the node at this position (see \ref getLogPositionVariable),
+*        so that there are a logarithmic number of variables for each position. Nodes at the positions are all different.
+* @param ctx the context of the solver
+* @param graph the graph
+* @param number the graph number
+* @param pathLength the path's length
+* @return a formula satisfiable only if the graph has a simple accepting path of length @p pathLength
 */
-bool isEmpty(File_t *file);
+Z3_ast makeLogFormula(Z3_context ctx, Graph graph, int number, int pathLength);
 
 /**
-* @brief pull get and delete the element at the top of the file
-* @param file is the file
-* @return the element on the top of the file
+* @brief getEdgeVariable gives the variable of \ref makeSuccessorFormula telling that the edge (@p source, @p target) is in the path of graph @p number
+* @param ctx the context of the solver
+* @param number the graph number
+* @param k the path's length
+* @param source the source of the edge
+* @param target the target of the edge
 */
-fileElement_t pull(File_t *file);
+Z3_ast getEdgeVariable(Z3_context ctx, int number, int k, int source, int target);
 
 /**
-* @brief push add an element at the end of the file
-* @param file is the file
-* @param element is the element to add
+* @brief getOrderVariable gives the integer variable of \ref makeSuccessorFormula giving the position of @p node if it is in the path of graph @p number
+* @param ctx the context of the solver
+* @param number the graph number
+* @param k the path's length
+* @param node the node
 */
-void push(File_t *file, fileElement_t element);
+Z3_ast getOrderVariable(Z3_context ctx, int number, int k, int node);
 
 /**
-* @brief print a file
-* @param file the file to print
-*
-* This function is used for debug
+* @brief getLogPositionVariable gives the bit-vector variable of \ref makeLogFormula giving the node at @p position in the path of graph @p number
+* @param ctx the context of the solver
+* @param number the graph number
+* @param k the path's length
+* @param position the position
+* @param size the number of bits of the variable
 */
-void printFile(File_t *file);
+Z3_ast getLogPositionVariable(Z3_context ctx, int number, int k, int position, unsigned int size);
 
 /**
-* @brief get the first element in the file
-* @param file the file
-* @return the element
-*
-* this function don't delete the element in the file
+* @brief the encodings available, the first one being the default one
 */
-fileElement_t top(File_t* file);
+const PathEncoding PATH_ENCODINGS[] = {
+	{"onehot", "a variable for each pair (node, position) (default)", makeOneHotFormula},
+	{"successor", "a variable for each edge, with integer positions ordering the path", makeSuccessorFormula},
+	{"log", "the node at each position written in binary", makeLogFormula}
+};
+#define NUM_PATH_ENCODINGS	(int)(sizeof(PATH_ENCODINGS)/sizeof(PathEncoding))
+
+const PathEncoding *currentPathEncoding = &PATH_ENCODINGS[0];	// encoding used by \ref graphsToPathFormula
+#define DOT_BUFFER_SIZE		(1 << 20)		// size of the buffer used to write dot files
 
 /**
 * @brief get the source node in a graph
@@ -106,10 +125,11 @@ Z3_ast makeValidFormula(Z3_context ctx, Graph graph, int number, int pathLength)
 * @param graph the graph 
 * @param number the graph number
 * @param pathLength the pathLength of the path
-* @param nodeTab an array of arrays wich contain the possible nodes for each position in the path
+* @param nodeTab an array of arrays wich contain the possible nodes for each position in the path, each one ended by -1
+* @param onlyOnce if false, a node is not forbidden at the other positions: there is only one node per position (see \ref solvePathLazily)
 * @return the maked formula 
 */
-Z3_ast makeSimpleFormula(Z3_context ctx, Graph graph, int number, int pathLength, int nodeTab[][MAX_ORDER_G]);
+Z3_ast makeSimpleFormula(Z3_context ctx, Graph graph, int number, int pathLength, int **nodeTab, bool onlyOnce);
 
 /**
 * @brief makePathFormula make a formula wich is satisfiable only if the graph has a path of length @p pathLength
@@ -117,11 +137,24 @@ Z3_ast makeSimpleFormula(Z3_context ctx, Graph graph, int number, int pathLength
 * @param graph the graph 
 * @param number the graph number
 * @param pathLength the pathLength of the path
-* @param nodeTab an array of arrays wich contain the possible nodes for each position in the path
+* @param nodeTab an array of arrays wich contain the possible nodes for each position in the path, each one ended by -1
 * @return the maked formula 
 */
-Z3_ast makePathFormula(Z3_context ctx, Graph graph, int number, int pathLength, int nodeTab[][MAX_ORDER_G]);
+Z3_ast makePathFormula(Z3_context ctx, Graph graph, int number, int pathLength, int **nodeTab);
+
 
+/**
+* @brief makeMandatoryFormula make a formula placing the nodes through which every accepting path goes (see \ref mandatoryNodes): each of them is at one of
+*        the positions between its distance from the source and @p pathLength minus its distance to the target, and at no other position.
+*        When there is a single such position, the formula is a unit fact.
+* @param ctx the context of the solver
+* @param graph the graph 
+* @param number the graph number
+* @param pathLength the pathLength of the path
+* @param nodeTab an array of arrays wich contain the possible nodes for each position in the path, each one ended by -1
+* @return the maked formula, true if there is no mandatory node
+*/
+Z3_ast makeMandatoryFormula(Z3_context ctx, Graph graph, int number, int pathLength, int **nodeTab);
 
 /**
 * @brief optimizeAndMakeFormula optimize or not the formula by reducing the number of nodes to use in the formula and then make formula
@@ -133,6 +166,54 @@ Z3_ast makePathFormula(Z3_context ctx, Graph graph, int number, int pathLength,
 */
 Z3_ast optimizeAndMakeFormula(Graph graph, Z3_context ctx, int number, int pathLength);
 
+/**
+* @brief getPossibleNodes gives the nodes which can be at each position of a path of length @p pathLength, which are all nodes if OPTIMIZE is false
+* @param graph the graph
+* @param pathLength the path's length
+* @return an array of @p pathLength + 1 arrays, each one ended by -1, to free with \ref deletePossibleNodes
+*/
+int **getPossibleNodes(Graph graph, int pathLength);
+
+/**
+* @brief deletePossibleNodes frees the arrays given by \ref getPossibleNodes
+* @param possibilities the arrays
+* @param pathLength the path's length given to \ref getPossibleNodes
+*/
+void deletePossibleNodes(int **possibilities, int pathLength);
+
+/**
+* @brief getLengthVariable gives the variable of the formula shared by all lengths telling that the common length is @p length
+* @param ctx the context of the solver
+* @param length the length
+*/
+Z3_ast getLengthVariable(Z3_context ctx, int length);
+
+/**
+* @brief getEndedVariable gives the variable of the formula shared by all lengths telling that the paths have ended before @p position
+* @param ctx the context of the solver
+* @param position the position
+*/
+Z3_ast getEndedVariable(Z3_context ctx, int position);
+
+/**
+* @brief getUsedVariable gives the variable of the formula shared by all lengths telling that @p node is in the path of graph @p number at @p position or before
+* @param ctx the context of the solver
+* @param number the graph number
+* @param position the position
+* @param node the node
+*/
+Z3_ast getUsedVariable(Z3_context ctx, int number, int position, int node);
+
+/**
+* @brief makeSharedFormula makes the part of the formula shared by all lengths (see \ref graphsToSharedFormula) about one graph
+* @param ctx the context of the solver
+* @param graph the graph
+* @param number the graph number
+* @param maxLength the greatest length of path considered
+* @return a formula satisfiable only if the graph has a simple accepting path of the length whose variable (see \ref getLengthVariable) is true
+*/
+Z3_ast makeSharedFormula(Z3_context ctx, Graph graph, int number, int maxLength);
+
 /**
 * @brief makeAnd make a formula wich is an AND between two formulas
 * @param ctx the context of the solver
@@ -141,6 +222,64 @@ Z3_ast optimizeAndMakeFormula(Graph graph, Z3_context ctx, int number, int pathL
 */
 Z3_ast makeAnd(Z3_context ctx,Z3_ast formula1, Z3_ast formula2);
 
+/**
+* @brief getTrueVariableName reads the @p index th constant of @p model
+* @param ctx the context of the solver
+* @param model the model
+* @param index the index of the constant in the model (lower than Z3_model_get_num_consts)
+* @return the name of the constant if it is a boolean variable true in @p model, NULL otherwise
+*/
+const char *getTrueVariableName(Z3_context ctx, Z3_model model, unsigned int index);
+
+/**
+* @brief getTrueNodeVariable reads the @p index th constant of @p model and tells if it is a node variable (see \ref getNodeVariable) valuated to true
+* @param ctx the context of the solver
+* @param model the model
+* @param index the index of the constant in the model (lower than Z3_model_get_num_consts)
+* @param number filled with the graph number of the variable
+* @param position filled with the position of the variable
+* @param k filled with the length of path of the variable
+* @param node filled with the node of the variable
+* @return true if the constant is a node variable true in @p model, false otherwise
+*/
+bool getTrueNodeVariable(Z3_context ctx, Z3_model model, unsigned int index, int *number, int *position, int *k, int *node);
+
+/**
+* @brief getNodeAtPosition reads the @p index th constant of @p model and tells if it puts a node at a position of a path: a node variable true in @p model
+*        (see \ref getTrueNodeVariable) or a position of \ref makeLogFormula
+* @param ctx the context of the solver
+* @param model the model
+* @param index the index of the constant in the model (lower than Z3_model_get_num_consts)
+* @param number filled with the graph number of the variable
+* @param position filled with the position of the variable
+* @param k filled with the length of path of the variable
+* @param node filled with the node at the position (for \ref makeLogFormula, the number of nodes if there is none)
+* @return true if the constant puts a node at a position, false otherwise
+*/
+bool getNodeAtPosition(Z3_context ctx, Z3_model model, unsigned int index, int *number, int *position, int *k, int *node);
+
+/**
+* @brief getTrueEdgeVariable reads the @p index th constant of @p model and tells if it is an edge variable (see \ref getEdgeVariable) valuated to true
+* @param ctx the context of the solver
+* @param model the model
+* @param index the index of the constant in the model (lower than Z3_model_get_num_consts)
+* @param number filled with the graph number of the variable
+* @param k filled with the length of path of the variable
+* @param source filled with the source of the edge
+* @param target filled with the target of the edge
+* @return true if the constant is an edge variable true in @p model, false otherwise
+*/
+bool getTrueEdgeVariable(Z3_context ctx, Z3_model model, unsigned int index, int *number, int *k, int *source, int *target);
+
+/**
+* @brief isPathValid tests if @p path is an accepting path of length @p pathLength in @p graph
+* @param graph the graph
+* @param path the nodes of the path, from position 0 to @p pathLength
+* @param pathLength the length of the path
+* @return true if the path goes from the source to the target through edges of @p graph
+*/
+bool isPathValid(Graph graph, int *path, int pathLength);
+
 /*
 * used just for debug
 */
@@ -156,16 +295,88 @@ Z3_ast getNodeVariable(Z3_context ctx, int number, int position, int k, int node
 	return var;
 }
 
+Z3_ast getEdgeVariable(Z3_context ctx, int number, int k, int source, int target)
+{
+	char varName[NODE_VARIABLE_SIZE];
+	sprintf(varName,"S%d,%d,%d,%d", number, k, source, target);
+	return mk_bool_var(ctx, varName);
+}
+
+Z3_ast getOrderVariable(Z3_context ctx, int number, int k, int node)
+{
+	char varName[NODE_VARIABLE_SIZE];
+	sprintf(varName,"O%d,%d,%d", number, k, node);
+	return mk_int_var(ctx, varName);
+}
+
+Z3_ast getLogPositionVariable(Z3_context ctx, int number, int k, int position, unsigned int size)
+{
+	char varName[NODE_VARIABLE_SIZE];
+	sprintf(varName,"P%d,%d,%d", number, k, position);
+	return mk_bv_var(ctx, varName, size);
+}
+
+Z3_ast getLengthVariable(Z3_context ctx, int length)
+{
+	char varName[NODE_VARIABLE_SIZE];
+	sprintf(varName,"L%d", length);
+	return mk_bool_var(ctx, varName);
+}
+
+Z3_ast getEndedVariable(Z3_context ctx, int position)
+{
+	char varName[NODE_VARIABLE_SIZE];
+	sprintf(varName,"E%d", position);
+	return mk_bool_var(ctx, varName);
+}
+
+Z3_ast getUsedVariable(Z3_context ctx, int number, int position, int node)
+{
+	char varName[NODE_VARIABLE_SIZE];
+	sprintf(varName,"U%d,%d,%d", number, position, node);
+	return mk_bool_var(ctx, varName);
+}
+
+int numPathEncodings(void)
+{
+	return NUM_PATH_ENCODINGS;
+}
+
+const PathEncoding *getPathEncoding(int index)
+{
+	return &PATH_ENCODINGS[index];
+}
+
+const PathEncoding *findPathEncoding(const char *name)
+{
+	for(int i=0; i<NUM_PATH_ENCODINGS; i++)
+	{
+		if(strcmp(PATH_ENCODINGS[i].name, name) == 0)
+			return &PATH_ENCODINGS[i];
+	}
+	return NULL;
+}
+
+void setPathEncoding(const PathEncoding *encoding)
+{
+	currentPathEncoding = encoding;
+}
+
+const PathEncoding *getCurrentPathEncoding(void)
+{
+	return currentPathEncoding;
+}
+
 Z3_ast graphsToPathFormula( Z3_context ctx, Graph *graphs,unsigned int numGraphs, int pathLength)
 {
 	Z3_ast formula;
-	Z3_ast tabFormula[numGraphs];
-	for(int i=0; i<numGraphs; i++)
+	Z3_ast *tabFormula = (Z3_ast *)malloc(numGraphs*sizeof(Z3_ast));
+	for(unsigned int i=0; i<numGraphs; i++)
 	{
-		int node = getSouceNode(graphs[i]);
-		tabFormula[i] = optimizeAndMakeFormula(graphs[i], ctx, i ,pathLength);	
+		tabFormula[i] = currentPathEncoding->makeFormula(ctx, graphs[i], i ,pathLength);	
 	}
 	formula = Z3_mk_and(ctx, numGraphs, tabFormula);
+	free(tabFormula);
 	return formula;
 }
 
@@ -173,212 +384,630 @@ Z3_ast graphsToPathFormula( Z3_context ctx, Graph *graphs,unsigned int numGraphs
 
 Z3_ast graphsToFullFormula( Z3_context ctx, Graph *graphs,unsigned int numGraphs)
 {
-	int min_vertices = orderG(graphs[0]);
-	for(int i=1; i<numGraphs; i++)
-	{
-		if(orderG(graphs[i]) < min_vertices)
-			min_vertices = orderG(graphs[i]);	
-	}
+	int maxLength;
+	bool *possible = possibleCommonLengths(graphs, numGraphs, &maxLength);
 	Z3_ast formula;
-	Z3_ast tabFormula[min_vertices];
-	int k=0;
-	while(k <= min_vertices - 1)
+	Z3_ast *tabFormula = (Z3_ast *)malloc((maxLength+1)*sizeof(Z3_ast));
+	int numFormulas = 0;
+	for(int k=0; k<=maxLength; k++)
 	{
-		tabFormula[k] = graphsToPathFormula(ctx, graphs, numGraphs, k);
-		if(isFormulaSat(ctx, tabFormula[k]) == Z3_L_TRUE)
+		if(!possible[k])
+			continue;
+		tabFormula[numFormulas++] = graphsToPathFormula(ctx, graphs, numGraphs, k);
+		if(isFormulaSat(ctx, tabFormula[numFormulas-1]) == Z3_L_TRUE)
 			break;
-		k++;
 	}
-	formula = Z3_mk_or(ctx, k+1, tabFormula);
+	formula = numFormulas > 0 ? Z3_mk_or(ctx, numFormulas, tabFormula) : Z3_mk_false(ctx);
+	free(tabFormula);
+	free(possible);
 	return formula;
 }
 
-void printPathsFromModel(Z3_context ctx, Z3_model model, Graph *graphs, int numGraph, int pathLength)
+bool commonLengthBounds(Graph *graphs, unsigned int numGraphs, int *low, int *high)
 {
-	int nodesPath[numGraph][pathLength + 1];	// will contain the path for each graph
+	*low = 0;
+	*high = -1;
+	for(unsigned int i=0; i<numGraphs; i++)
+	{
+		int lower, upper;
+		lengthBounds(graphs[i], &lower, &upper);
+		if(lower == -1)
+		{
+			*low = 0;
+			*high = -1;
+			return false;
+		}
+		if(lower > *low)
+			*low = lower;
+		if(i == 0 || upper < *high)
+			*high = upper;
+	}
+	return numGraphs > 0 && *low <= *high;
+}
 
-	/* for each graph, for each node check if it is true between 0 to pathLength. IF it's true this node belongs to the path */
-	for(int numCurrentGraph=0; numCurrentGraph<numGraph; numCurrentGraph++)
+bool *possibleCommonLengths(Graph *graphs, unsigned int numGraphs, int *maxLength)
+{
+	int low, high;
+	bool nonEmpty = commonLengthBounds(graphs, numGraphs, &low, &high);
+	*maxLength = high > 0 ? high : 0;
+	bool *possible = (bool *)malloc((*maxLength+1)*sizeof(bool));
+	for(int k=0; k<=*maxLength; k++)
+		possible[k] = nonEmpty && k >= low;
+
+	/* a length is kept if it has the residue of each graph modulo its period */
+	for(unsigned int i=0; i<numGraphs && nonEmpty; i++)
 	{
-		for(int node=0; node<orderG(graphs[numCurrentGraph]); node++)
+		int period, residue;
+		lengthPeriod(graphs[i], &period, &residue);
+		for(int k=0; k<=*maxLength; k++)
 		{
-			for(int posInPath=0; posInPath<=pathLength; posInPath++)
+			if(period > 0 ? k % period != residue : k != residue)
+				possible[k] = false;
+		}
+	}
+	return possible;
+}
+
+int maxCommonLength(Graph *graphs, unsigned int numGraphs)
+{
+	int low, high;
+	commonLengthBounds(graphs, numGraphs, &low, &high);
+	return high > 0 ? high : 0;
+}
+
+Z3_ast graphsToSharedFormula( Z3_context ctx, Graph *graphs,unsigned int numGraphs)
+{
+	return graphsToLengthsFormula(ctx, graphs, numGraphs, NULL, 0);
+}
+
+Z3_ast graphsToLengthsFormula( Z3_context ctx, Graph *graphs,unsigned int numGraphs, const bool *lengths, int numLengths)
+{
+	int maxLength;
+	bool *possible = possibleCommonLengths(graphs, numGraphs, &maxLength);
+	if(lengths != NULL && numLengths-1 < maxLength)
+		maxLength = numLengths-1;
+
+	Z3_ast *tabFormula = (Z3_ast *)malloc((numGraphs + 3*maxLength + 2)*sizeof(Z3_ast));
+	int numFormulas = 0;
+	for(unsigned int i=0; i<numGraphs; i++)
+		tabFormula[numFormulas++] = makeSharedFormula(ctx, graphs[i], i, maxLength);
+
+	/* one allowed length is selected: the paths have ended after it, and not before */
+	Z3_ast *selectors = (Z3_ast *)malloc((maxLength+1)*sizeof(Z3_ast));
+	int numSelectors = 0;
+	for(int k=0; k<=maxLength; k++)
+	{
+		Z3_ast length = getLengthVariable(ctx, k);
+		if(k > 0)
+			tabFormula[numFormulas++] = Z3_mk_implies(ctx, length, Z3_mk_not(ctx, getEndedVariable(ctx, k)));
+		if(k < maxLength)
+			tabFormula[numFormulas++] = Z3_mk_implies(ctx, length, getEndedVariable(ctx, k+1));
+		if(possible[k] && (lengths == NULL || lengths[k]))
+			selectors[numSelectors++] = length;
+	}
+	tabFormula[numFormulas++] = numSelectors > 0 ? Z3_mk_or(ctx, numSelectors, selectors) : Z3_mk_false(ctx);
+	for(int pos=1; pos<maxLength; pos++)
+		tabFormula[numFormulas++] = Z3_mk_implies(ctx, getEndedVariable(ctx, pos), getEndedVariable(ctx, pos+1));
+
+	Z3_ast formula = Z3_mk_and(ctx, numFormulas, tabFormula);
+	free(possible);
+	free(selectors);
+	free(tabFormula);
+	return formula;
+}
+
+const char *getTrueVariableName(Z3_context ctx, Z3_model model, unsigned int index)
+{
+	Z3_func_decl decl = Z3_model_get_const_decl(ctx, model, index);
+	Z3_ast value = Z3_model_get_const_interp(ctx, model, decl);
+	if(value == NULL || Z3_get_bool_value(ctx, value) != Z3_L_TRUE)
+		return NULL;
+
+	Z3_symbol symbol = Z3_get_decl_name(ctx, decl);
+	if(Z3_get_symbol_kind(ctx, symbol) != Z3_STRING_SYMBOL)
+		return NULL;
+	return Z3_get_symbol_string(ctx, symbol);
+}
+
+int findExtremeLength(Z3_context ctx, Graph *graphs, unsigned int numGraphs, const bool *lengths, int numLengths, bool longest, Z3_model *model, bool *proven)
+{
+	int maxLength = maxCommonLength(graphs, numGraphs);
+	if(lengths != NULL && numLengths-1 < maxLength)
+		maxLength = numLengths-1;
+	Z3_solver solver = makeSolver(ctx);
+	Z3_solver_assert(ctx, solver, graphsToLengthsFormula(ctx, graphs, numGraphs, lengths, numLengths));
+
+	int length = -1;
+	Z3_lbool result = checkWithAssumption(ctx, solver, NULL, model);
+	*proven = result != Z3_L_UNDEF;
+	if(result == Z3_L_TRUE)
+	{
+		/* dichotomy on the lengths not excluded yet, in the same solver: "the length is at least m" is "not ended at m", "at most m" is "ended at m+1" */
+		length = getSolutionLengthFromModel(ctx, *model, graphs);
+		int low = longest ? length : 0;
+		int high = longest ? maxLength : length;
+		while(low < high)
+		{
+			int middle = longest ? (low + high + 1)/2 : (low + high)/2;
+			Z3_ast bound = longest ? Z3_mk_not(ctx, getEndedVariable(ctx, middle)) : getEndedVariable(ctx, middle+1);
+			Z3_model better;
+			result = checkWithAssumption(ctx, solver, bound, &better);
+			*proven = *proven && result != Z3_L_UNDEF;
+			if(result == Z3_L_TRUE)
+			{
+				Z3_model_dec_ref(ctx, *model);
+				*model = better;
+				length = getSolutionLengthFromModel(ctx, *model, graphs);
+				if(longest)
+					low = length;
+				else
+					high = length;
+			}
+			else
 			{
-				char varName[NODE_VARIABLE_SIZE];
-				sprintf(varName,"X%d,%d,%d,%d", numCurrentGraph, posInPath, pathLength, node);
-				Z3_ast var = mk_bool_var(ctx, varName);
-				int nodeValuation = valueOfVarInModel(ctx, model, var);
-				if(nodeValuation == 1)
+				if(better)
+					Z3_model_dec_ref(ctx, better);
+				if(longest)
+					high = middle-1;
+				else
+					low = middle+1;
+			}
+		}
+	}
+	else if(*model)
+	{
+		Z3_model_dec_ref(ctx, *model);
+		*model = 0;
+	}
+	Z3_solver_dec_ref(ctx, solver);
+	return length;
+}
+
+Z3_lbool solvePathLazily(Z3_context ctx, Graph *graphs, unsigned int numGraphs, int pathLength, Z3_model *model)
+{
+	Z3_solver solver = makeSolver(ctx);
+	int ***possibilities = (int ***)malloc(numGraphs*sizeof(int **));
+	for(unsigned int i=0; i<numGraphs; i++)
+	{
+		possibilities[i] = getPossibleNodes(graphs[i], pathLength);
+		Z3_solver_assert(ctx, solver, makeValidFormula(ctx, graphs[i], i, pathLength));
+		Z3_solver_assert(ctx, solver, makePathFormula(ctx, graphs[i], i, pathLength, possibilities[i]));
+		Z3_solver_assert(ctx, solver, makeSimpleFormula(ctx, graphs[i], i, pathLength, possibilities[i], false));
+		if(MANDATORY_NODES)
+			Z3_solver_assert(ctx, solver, makeMandatoryFormula(ctx, graphs[i], i, pathLength, possibilities[i]));
+	}
+
+	/*
+	* each walk found is followed from the source: a node repeated in it is then used at most once in the whole path, and the solver is called again.
+	* A walk without repetition is a simple path, and a simple path satisfies all the constraints added, so nothing is lost.
+	*/
+	Z3_ast *occurrences = (Z3_ast *)malloc((pathLength+1)*sizeof(Z3_ast));
+	Z3_lbool result;
+	while((result = checkWithAssumption(ctx, solver, NULL, model)) == Z3_L_TRUE)
+	{
+		int **paths = getPathsFromModel(ctx, *model, graphs, numGraphs, pathLength);
+		bool simple = true;
+		for(unsigned int i=0; i<numGraphs; i++)
+		{
+			for(int pos=0; pos<=pathLength; pos++)
+			{
+				int node = paths[i][pos];
+				bool repeated = false;
+				for(int next=pos+1; next<=pathLength && node != -1 && !repeated; next++)
+					repeated = paths[i][next] == node;
+				if(!repeated)
+					continue;
+				/* the later occurrences are forgotten, so that the constraint is added once */
+				for(int next=pos+1; next<=pathLength; next++)
+				{
+					if(paths[i][next] == node)
+						paths[i][next] = -1;
+				}
+				int numOccurrences = 0;
+				for(int j=0; j<=pathLength; j++)
 				{
-					nodesPath[numCurrentGraph][posInPath] = node;
+					for(int n=0; possibilities[i][j][n] != -1; n++)
+					{
+						if(possibilities[i][j][n] == node)
+							occurrences[numOccurrences++] = getNodeVariable(ctx, i, j, pathLength, node);
+					}
+				}
+				Z3_solver_assert(ctx, solver, Z3_mk_atmost(ctx, numOccurrences, occurrences, 1));
+				simple = false;
+			}
+		}
+		deletePaths(paths, numGraphs);
+		if(simple)
+			break;
+		Z3_model_dec_ref(ctx, *model);
+	}
+	if(result != Z3_L_TRUE && *model)
+	{
+		Z3_model_dec_ref(ctx, *model);
+		*model = 0;
+	}
+
+	free(occurrences);
+	for(unsigned int i=0; i<numGraphs; i++)
+		deletePossibleNodes(possibilities[i], pathLength);
+	free(possibilities);
+	Z3_solver_dec_ref(ctx, solver);
+	return result;
+}
+
+unsigned int getPathHints(Z3_context ctx, Graph graph, int number, int pathLength, int *path, int hintLength, Z3_ast *hints)
+{
+	unsigned int numHints = 0;
+	for(int pos=0; pos<=pathLength && pos<=hintLength; pos++)
+	{
+		if(path[pos] == -1 || (isTarget(graph, path[pos]) && pos != pathLength))
+			continue;
+		hints[numHints++] = getNodeVariable(ctx, number, pos, pathLength, path[pos]);
+	}
+	return numHints;
+}
+
+bool getTrueNodeVariable(Z3_context ctx, Z3_model model, unsigned int index, int *number, int *position, int *k, int *node)
+{
+	const char *name = getTrueVariableName(ctx, model, index);
+	return name != NULL && sscanf(name, "X%d,%d,%d,%d", number, position, k, node) == 4;
+}
+
+bool getNodeAtPosition(Z3_context ctx, Z3_model model, unsigned int index, int *number, int *position, int *k, int *node)
+{
+	if(getTrueNodeVariable(ctx, model, index, number, position, k, node))
+		return true;
+
+	Z3_func_decl decl = Z3_model_get_const_decl(ctx, model, index);
+	Z3_symbol symbol = Z3_get_decl_name(ctx, decl);
+	if(Z3_get_symbol_kind(ctx, symbol) != Z3_STRING_SYMBOL || sscanf(Z3_get_symbol_string(ctx, symbol), "P%d,%d,%d", number, k, position) != 3)
+		return false;
+	Z3_ast value = Z3_model_get_const_interp(ctx, model, decl);
+	unsigned int code;
+	if(value == NULL || !Z3_get_numeral_uint(ctx, value, &code))
+		return false;
+	*node = code;
+	return true;
+}
+
+bool getTrueEdgeVariable(Z3_context ctx, Z3_model model, unsigned int index, int *number, int *k, int *source, int *target)
+{
+	const char *name = getTrueVariableName(ctx, model, index);
+	return name != NULL && sscanf(name, "S%d,%d,%d,%d", number, k, source, target) == 4;
+}
+
+bool isPathValid(Graph graph, int *path, int pathLength)
+{
+	if(path[0] != getSouceNode(graph) || path[pathLength] != getTargetNode(graph))
+		return false;
+	int last = 0;
+	for(int pos=1; pos<=pathLength; pos++)
+	{
+		if(path[pos] == -1)
+			continue;
+		if(edgeWeight(graph, path[last], path[pos]) != pos - last)
+			return false;
+		last = pos;
+	}
+	return true;
+}
+
+int **getPathsFromModel(Z3_context ctx, Z3_model model, Graph *graphs, int numGraph, int pathLength)
+{
+	int numBuckets = numGraph*(pathLength+1);
+	unsigned int numConsts = Z3_model_get_num_consts(ctx, model);
+	int *bucketOf = (int *)malloc((numConsts+1)*sizeof(int));
+	int *nodeOf = (int *)malloc((numConsts+1)*sizeof(int));
+	int *bucketStart = (int *)calloc(numBuckets+1, sizeof(int));
+	int *trueNodes = (int *)malloc((numConsts+1)*sizeof(int));
+	int **nextNode = (int **)calloc(numGraph, sizeof(int *));
+
+	/*
+	* only the variables true in the model matter: each of them puts a node at a position of a path (they are sorted by (graph, position)),
+	* or puts an edge in a path with \ref makeSuccessorFormula (nextNode[i][node] is then the node following node in the path of graph i)
+	*/
+	for(unsigned int i=0; i<numConsts; i++)
+	{
+		int number, position, k, node, target;
+		bucketOf[i] = -1;
+		if(getNodeAtPosition(ctx, model, i, &number, &position, &k, &node) && (k == pathLength || k == ANY_LENGTH)
+			&& number >= 0 && number < numGraph && position >= 0 && position <= pathLength)
+		{
+			bucketOf[i] = number*(pathLength+1) + position;
+			nodeOf[i] = node;
+			bucketStart[bucketOf[i]+1]++;
+		}
+		else if(getTrueEdgeVariable(ctx, model, i, &number, &k, &node, &target) && k == pathLength && number >= 0 && number < numGraph)
+		{
+			if(nextNode[number] == NULL)
+			{
+				nextNode[number] = (int *)malloc((orderG(graphs[number])+1)*sizeof(int));
+				for(int j=0; j<orderG(graphs[number]); j++)
+					nextNode[number][j] = -1;
+			}
+			nextNode[number][node] = target;
+		}
+	}
+	for(int bucket=0; bucket<numBuckets; bucket++)
+		bucketStart[bucket+1] += bucketStart[bucket];
+	int *fill = (int *)malloc((numBuckets+1)*sizeof(int));
+	memcpy(fill, bucketStart, (numBuckets+1)*sizeof(int));
+	for(unsigned int i=0; i<numConsts; i++)
+	{
+		if(bucketOf[i] != -1)
+			trueNodes[fill[bucketOf[i]]++] = nodeOf[i];
+	}
+
+	/*
+	* variables of nodes that cannot be at a position (see \ref optimizeAndMakeFormula) are not constrained and may be true,
+	* so the path is followed from the source: the next node is a successor of the current one, true at the position reached through the edge between them
+	*/
+	int **paths = (int **)malloc(numGraph*sizeof(int *));
+	for(int i=0; i<numGraph; i++)
+	{
+		paths[i] = (int *)malloc((pathLength+1)*sizeof(int));
+		for(int pos=0; pos<=pathLength; pos++)
+			paths[i][pos] = -1;
+
+		/* every encoding puts the source at position 0 */
+		int source = getSouceNode(graphs[i]);
+		paths[i][0] = source;
+		int pos = 0;
+		if(nextNode[i] != NULL)
+		{
+			for(int node=source; pos < pathLength && nextNode[i][node] != -1; node=nextNode[i][node])
+			{
+				pos += edgeWeight(graphs[i], node, nextNode[i][node]);
+				if(pos > pathLength)
 					break;
+				paths[i][pos] = nextNode[i][node];
+			}
+			free(nextNode[i]);
+			continue;
+		}
+		while(pos < pathLength && paths[i][pos] != -1)
+		{
+			int node = paths[i][pos];
+			int *successors = getSuccessors(graphs[i], node);
+			int next = -1;
+			for(int s=0; s<numSuccessors(graphs[i], node) && next == -1; s++)
+			{
+				int position = pos + successorWeight(graphs[i], node, s);
+				if(position > pathLength)
+					continue;
+				int bucket = i*(pathLength+1) + position;
+				for(int j=bucketStart[bucket]; j<bucketStart[bucket+1] && next == -1; j++)
+				{
+					if(trueNodes[j] == successors[s])
+					{
+						paths[i][position] = successors[s];
+						next = position;
+					}
 				}
 			}
+			if(next == -1)
+				break;
+			pos = next;
 		}
 	}
 
+	free(bucketOf);
+	free(nodeOf);
+	free(bucketStart);
+	free(fill);
+	free(trueNodes);
+	free(nextNode);
+	return paths;
+}
+
+void deletePaths(int **paths, int numGraph)
+{
+	for(int i=0; i<numGraph; i++)
+		free(paths[i]);
+	free(paths);
+}
+
+void printPaths(Graph *graphs, int numGraph, int pathLength, int **paths)
+{
 	/* for each graph print the path found*/
 	for(int numCurrentGraph=0; numCurrentGraph<numGraph; numCurrentGraph++)
 	{
 		printf("path in graph%d.\n", numCurrentGraph);
 		for(int posInPath=0; posInPath<=pathLength; posInPath++)
 		{
+			/* the positions crossed by a longer edge have no node */
+			if(paths[numCurrentGraph][posInPath] == -1)
+				continue;
 			if(posInPath<pathLength)
-				printf("%s-->", getNodeName(graphs[numCurrentGraph], nodesPath[numCurrentGraph][posInPath]));
+				printf("%s-->", getNodeName(graphs[numCurrentGraph], paths[numCurrentGraph][posInPath]));
 			else
-				printf("%s\n", getNodeName(graphs[numCurrentGraph], nodesPath[numCurrentGraph][posInPath]));
+				printf("%s\n", getNodeName(graphs[numCurrentGraph], paths[numCurrentGraph][posInPath]));
 		}
 	}
 }
 
-
-void createDotFromModel(Z3_context ctx, Z3_model model, Graph *graphs, int numGraph, int pathLength, char* name)
+void printPathsFromModel(Z3_context ctx, Z3_model model, Graph *graphs, int numGraph, int pathLength)
 {
-	int nodesPath[numGraph][pathLength + 1];
-	char pathName[strlen(name) + 5];
-	sprintf(pathName, "sol/");
-	
-	FILE *fd = fopen(strcat(pathName, name), "w");
-
-	if(fd == NULL){
-		fprintf(stderr, "Error when opening file\n");
-		exit(EXIT_FAILURE);
-	}
+	int **paths = getPathsFromModel(ctx, model, graphs, numGraph, pathLength);
+	printPaths(graphs, numGraph, pathLength, paths);
+	deletePaths(paths, numGraph);
+}
 
-	char line[100];
-	char solutionName[13];
-	sprintf(solutionName, "Sol_Length%d", pathLength);
-	sprintf(line, "digraph %s {\n", solutionName);
-	fputs(line, fd);
+void writeDotFromPaths(FILE *fd, Graph *graphs, int numGraph, int pathLength, int **paths)
+{
+	fprintf(fd, "digraph Sol_Length%d {\n", pathLength);
 
 	/* for each graph, write it in a dot file with colors witch show the path */
 	for(int i=0; i<numGraph; i++)
 	{
-		/* checking the path for the graph */
-		for(int node=0; node<orderG(graphs[i]); node++)
+		/*
+		* position of each node in the path (-1 if it is not in the path) and the node following it (-1 for none), so that nodes and edges of the path
+		* are found in constant time: the positions crossed by a longer edge (-1 in the path) are skipped
+		*/
+		int order = orderG(graphs[i]);
+		int *posInPath = (int *)malloc((order+1)*sizeof(int));
+		int *nextInPath = (int *)malloc((order+1)*sizeof(int));
+		for(int node=0; node<order; node++)
 		{
-			for(int posInPath=0; posInPath<=pathLength; posInPath++)
-			{
-				char varName[NODE_VARIABLE_SIZE];
-				sprintf(varName,"X%d,%d,%d,%d", i, posInPath, pathLength, node);
-				Z3_ast var = mk_bool_var(ctx, varName);
-				int nodeValuation = valueOfVarInModel(ctx, model, var);
-				if(nodeValuation == 1)
-				{
-					nodesPath[i][posInPath] = node;
-					break;
-				}
-			}
+			posInPath[node] = -1;
+			nextInPath[node] = -1;
+		}
+		int previous = -1;
+		for(int pos=0; pos<=pathLength; pos++)
+		{
+			if(paths[i][pos] == -1)
+				continue;
+			posInPath[paths[i][pos]] = pos;
+			if(previous != -1)
+				nextInPath[previous] = paths[i][pos];
+			previous = paths[i][pos];
 		}
-		
+
 		/* writing the source node and the target node */
 		int sourceNode = getSouceNode(graphs[i]);
 		int targetNode = getTargetNode(graphs[i]);
-		sprintf(line, "\t_%d_%s [initial=1, color=green] [style=filled, fillcolor=lightblue];\n", i, getNodeName(graphs[i], sourceNode)); 
-		fputs(line, fd);
-		sprintf(line, "\t_%d_%s [final=1, color=red] [style=filled, fillcolor=lightblue];\n", i, getNodeName(graphs[i], targetNode)); 
-		fputs(line, fd);
+		fprintf(fd, "\t_%d_%s [initial=1, color=green] [style=filled, fillcolor=lightblue];\n", i, getNodeName(graphs[i], sourceNode));
+		fprintf(fd, "\t_%d_%s [final=1, color=red] [style=filled, fillcolor=lightblue];\n", i, getNodeName(graphs[i], targetNode));
 
 		/* writing all nodes (without the source and the target) */
-		for(int node=0; node<orderG(graphs[i]); node++)
+		for(int node=0; node<order; node++)
 		{
-
-			if(node != sourceNode && node != targetNode){
-				int k = 0;
-				while(k<pathLength+1 && nodesPath[i][k] != node)
-					k++;	
-				if(k == pathLength + 1)
-					fprintf(fd, "\t_%d_%s ;\n", i, getNodeName(graphs[i], node));
-				else
-					fprintf(fd, "\t_%d_%s [style=filled, fillcolor=lightblue];\n", i, getNodeName(graphs[i], node));
-			}
+			if(node == sourceNode || node == targetNode)
+				continue;
+			if(posInPath[node] == -1)
+				fprintf(fd, "\t_%d_%s ;\n", i, getNodeName(graphs[i], node));
+			else
+				fprintf(fd, "\t_%d_%s [style=filled, fillcolor=lightblue];\n", i, getNodeName(graphs[i], node));
 		}
 
-		/* writting edges */
-		for(int node=0; node<orderG(graphs[i]); node++)
+		/* writting edges: an edge is in the path if its target follows its source in the path */
+		for(int node=0; node<order; node++)
 		{
-			for(int nodeBis=0; nodeBis<orderG(graphs[i]); nodeBis++)
+			int *successors = getSuccessors(graphs[i], node);
+			for(int j=0; j<numSuccessors(graphs[i], node); j++)
 			{
-				if(isEdge(graphs[i], node, nodeBis))
-				{
-					int k=0;
-					while(k<pathLength+1 && nodesPath[i][k] != node)
-						k++;
-					
-					if(k<pathLength+1 && nodesPath[i][k+1] == nodeBis && node != targetNode)
-						fprintf(fd, "\t_%d_%s -> _%d_%s [color=blue];\n", i, getNodeName(graphs[i], node), i, getNodeName(graphs[i], nodeBis));
-					else
-						fprintf(fd, "\t_%d_%s -> _%d_%s ;\n", i, getNodeName(graphs[i], node), i, getNodeName(graphs[i], nodeBis));
-				}
+				if(nextInPath[node] == successors[j])
+					fprintf(fd, "\t_%d_%s -> _%d_%s [color=blue];\n", i, getNodeName(graphs[i], node), i, getNodeName(graphs[i], successors[j]));
+				else
+					fprintf(fd, "\t_%d_%s -> _%d_%s ;\n", i, getNodeName(graphs[i], node), i, getNodeName(graphs[i], successors[j]));
 			}
 		}
+		free(posInPath);
+		free(nextInPath);
 	}
 	fprintf(fd, "}\n");
-	fclose(fd);
+}
+
+void createDotFromPaths(Graph *graphs, int numGraph, int pathLength, int **paths, char *name)
+{
+	FILE *fd = stdout;
+	char *fileName = NULL;
+	if(name == NULL || strcmp(name, "-") != 0)
+	{
+		if(name == NULL)
+			name = (char *)"result";
+		fileName = (char *)malloc(strlen(name) + 32);
+		sprintf(fileName, "%s-l%d.dot", name, pathLength);
+		fd = fopen(fileName, "w");
+		if(fd == NULL){
+			fprintf(stderr, "Error when opening file %s\n", fileName);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	/* a big buffer: the file is written in a few system calls whatever the number of nodes and edges */
+	char *buffer = NULL;
+	if(fd != stdout)
+	{
+		buffer = (char *)malloc(DOT_BUFFER_SIZE);
+		setvbuf(fd, buffer, _IOFBF, DOT_BUFFER_SIZE);
+	}
+
+	writeDotFromPaths(fd, graphs, numGraph, pathLength, paths);
+
+	if(fd == stdout)
+		fflush(fd);
+	else
+		fclose(fd);
+	free(buffer);
+	free(fileName);
+}
+
+void createDotFromModel(Z3_context ctx, Z3_model model, Graph *graphs, int numGraph, int pathLength, char* name)
+{
+	int **paths = getPathsFromModel(ctx, model, graphs, numGraph, pathLength);
+	createDotFromPaths(graphs, numGraph, pathLength, paths, name);
+	deletePaths(paths, numGraph);
 }
 
 
 int getSolutionLengthFromModel(Z3_context ctx, Z3_model model, Graph *graphs)
 {	
 	unsigned int graphNumber = 0;
-	unsigned int solutionLength = 0;
+	int order = maxPathLength(graphs[graphNumber]) + 1;
 	int sourceNode = getSouceNode(graphs[graphNumber]);
-	int targetNode = getTargetNode(graphs[graphNumber]);
-	
+
 	/*
 	* we search the size of the solution just by using the graph 0 . It is not necessary to check the path for each graph
-	* because they all have the same pathLength in the model
+	* because they all have the same pathLength in the model.
+	* Every length whose source variable is true or whose path leaves the source is a candidate (and 0, for a source which is also the target),
+	* the smallest one for which the model describes a valid path is the solution.
 	*/
+	bool *candidates = (bool *)calloc(order+1, sizeof(bool));
 
-	/* tring from solutionLength equal to 0 until we find the right solutionLength */
-	while(solutionLength < orderG(graphs[graphNumber]))
+	/* with the formula shared by all lengths (see \ref graphsToSharedFormula), the solution is the selected length */
+	unsigned int numConsts = Z3_model_get_num_consts(ctx, model);
+	for(unsigned int i=0; i<numConsts; i++)
 	{
-		int currentNode = sourceNode;
-		for(int pos=0; pos<=solutionLength; pos++)
+		const char *name = getTrueVariableName(ctx, model, i);
+		int length;
+		if(name != NULL && sscanf(name, "L%d", &length) == 1)
 		{
-			if(pos == solutionLength)
-			{
-				Z3_ast varSourceNode = getNodeVariable(ctx, graphNumber, 0, solutionLength, sourceNode);
-				Z3_ast varTargetNode= getNodeVariable(ctx, graphNumber, solutionLength, solutionLength, targetNode);
-				if(valueOfVarInModel(ctx, model, varSourceNode) == 1 && valueOfVarInModel(ctx, model, varTargetNode) == 1)
-					return solutionLength;
-				else
-					break;
-			}
-			int lastCurrentNode = currentNode;
-			for(int neighbour=0; neighbour<orderG(graphs[graphNumber]); neighbour++)
-			{
-				if(isEdge(graphs[graphNumber], currentNode, neighbour))
-				{
-					Z3_ast var = getNodeVariable(ctx, graphNumber, pos + 1, solutionLength, neighbour);
-					if(valueOfVarInModel(ctx, model, var) == 1)
-					{
-						currentNode = neighbour;	
-						break;
-					}
-				}
-			}
-			if(currentNode == lastCurrentNode)
-				break;
+			free(candidates);
+			return length;
 		}
-		
-		solutionLength +=1;
 	}
 
+	candidates[0] = true;
+	for(unsigned int i=0; i<numConsts; i++)
+	{
+		int number, position, k, node;
+		if(getNodeAtPosition(ctx, model, i, &number, &position, &k, &node) && number == (int)graphNumber
+			&& position == 0 && node == sourceNode && k >= 0 && k < order)
+			candidates[k] = true;
+		if(getTrueEdgeVariable(ctx, model, i, &number, &k, &node, &position) && number == (int)graphNumber
+			&& node == sourceNode && k >= 0 && k < order)
+			candidates[k] = true;
+	}
+
+	for(int solutionLength=0; solutionLength<order; solutionLength++)
+	{
+		if(!candidates[solutionLength])
+			continue;
+		int **paths = getPathsFromModel(ctx, model, graphs, 1, solutionLength);
+		bool valid = isPathValid(graphs[graphNumber], paths[0], solutionLength);
+		deletePaths(paths, 1);
+		if(valid)
+		{
+			free(candidates);
+			return solutionLength;
+		}
+	}
+	free(candidates);
+
 	fprintf(stderr, "this case should not happen\n"); /* this case will not happen */
 	exit(EXIT_FAILURE);
-	return solutionLength;			// just to make gcc happy (desabling warnings)
+	return -1;			// just to make gcc happy (desabling warnings)
 }
 
 Z3_ast makeValidFormula(Z3_context ctx, Graph graph, int number, int pathLength)
 {
 	unsigned int tabFormulaSize = orderG(graph) + 1;
-	Z3_ast tabFormulaOr[tabFormulaSize];
+	Z3_ast *tabFormulaOr = (Z3_ast *)malloc(tabFormulaSize*sizeof(Z3_ast));
 	int source = getSouceNode(graph);
 	int target = getTargetNode(graph);
 	tabFormulaOr[0] = getNodeVariable(ctx, number, 0, pathLength, source);
 	tabFormulaOr[1] = getNodeVariable(ctx, number, pathLength, pathLength, target);
-	int node;
 	Z3_ast formula; 
 
 	int i=2;
@@ -390,13 +1019,14 @@ Z3_ast makeValidFormula(Z3_context ctx, Graph graph, int number, int pathLength)
 		}
 	}
 	formula = Z3_mk_and(ctx, tabFormulaSize ,tabFormulaOr);
+	free(tabFormulaOr);
 	return formula;
 }
 
-Z3_ast makeSimpleFormula(Z3_context ctx, Graph graph, int number, int pathLength, int nodeTab[][MAX_ORDER_G])
+Z3_ast makeSimpleFormula(Z3_context ctx, Graph graph, int number, int pathLength, int **nodeTab, bool onlyOnce)
 {
 	int sizeTabFormulaAnd1 = pathLength + 1;	
-	Z3_ast tabFormulaAnd1[sizeTabFormulaAnd1];
+	Z3_ast *tabFormulaAnd1 = (Z3_ast *)malloc(sizeTabFormulaAnd1*sizeof(Z3_ast));
 	int indiceTabFormulaAnd1 = 0;
 	Z3_ast formula;
 
@@ -406,12 +1036,12 @@ Z3_ast makeSimpleFormula(Z3_context ctx, Graph graph, int number, int pathLength
 		while(nodeTab[pos][sizeTabFormulaOr] != -1)
 			sizeTabFormulaOr += 1;
 		int sizeTabFormulaAnd2 = pathLength + sizeTabFormulaOr;
-		Z3_ast tabFormulaOr[sizeTabFormulaOr];
+		Z3_ast *tabFormulaOr = (Z3_ast *)malloc((sizeTabFormulaOr+1)*sizeof(Z3_ast));
+		Z3_ast *tabFormulaAnd2 = (Z3_ast *)malloc(sizeTabFormulaAnd2*sizeof(Z3_ast));
 
 		int indiceTabFormulaOr = 0;
 		for(int i=0; i<sizeTabFormulaOr; i++)
 		{
-			Z3_ast tabFormulaAnd2[sizeTabFormulaAnd2];
 			int indiceTabFormulaAnd2 = 0;
 			tabFormulaAnd2[indiceTabFormulaAnd2++] = getNodeVariable(ctx, number, pos, pathLength,nodeTab[pos][i]);
 			for(int j=0; j<sizeTabFormulaOr; j++)
@@ -424,7 +1054,7 @@ Z3_ast makeSimpleFormula(Z3_context ctx, Graph graph, int number, int pathLength
 				}
 			}
 
-			for(int j=0; j<=pathLength; j++)
+			for(int j=0; j<=pathLength && onlyOnce; j++)
 			{
 				if(j!=pos)
 				{
@@ -433,41 +1063,45 @@ Z3_ast makeSimpleFormula(Z3_context ctx, Graph graph, int number, int pathLength
 					tabFormulaAnd2[indiceTabFormulaAnd2++] = var;
 				}
 			}
-			tabFormulaOr[indiceTabFormulaOr++] = Z3_mk_and(ctx, sizeTabFormulaAnd2, tabFormulaAnd2);
+			tabFormulaOr[indiceTabFormulaOr++] = Z3_mk_and(ctx, indiceTabFormulaAnd2, tabFormulaAnd2);
+		}
+
+		/* when edges are longer than one, positions crossed by an edge have no node */
+		if(graph.weights != NULL)
+		{
+			for(int i=0; i<sizeTabFormulaOr; i++)
+				tabFormulaAnd2[i] = Z3_mk_not(ctx, getNodeVariable(ctx, number, pos, pathLength, nodeTab[pos][i]));
+			tabFormulaOr[indiceTabFormulaOr++] = Z3_mk_and(ctx, sizeTabFormulaOr, tabFormulaAnd2);
 		}
-		if(sizeTabFormulaOr != 1)
-			tabFormulaAnd1[indiceTabFormulaAnd1++] = Z3_mk_or(ctx, sizeTabFormulaOr, tabFormulaOr);
+		if(indiceTabFormulaOr != 1)
+			tabFormulaAnd1[indiceTabFormulaAnd1++] = Z3_mk_or(ctx, indiceTabFormulaOr, tabFormulaOr);
 		else
 			tabFormulaAnd1[indiceTabFormulaAnd1++] = tabFormulaOr[0];
+		free(tabFormulaOr);
+		free(tabFormulaAnd2);
 	}
 	formula = Z3_mk_and(ctx, sizeTabFormulaAnd1, tabFormulaAnd1); 
+	free(tabFormulaAnd1);
 	return formula;
 }
 
-Z3_ast makePathFormula(Z3_context ctx, Graph graph, int number, int pathLength, int nodeTab[][MAX_ORDER_G])
+Z3_ast makePathFormula(Z3_context ctx, Graph graph, int number, int pathLength, int **nodeTab)
 {
-	Z3_ast tabAnd1[pathLength];
+	Z3_ast *tabAnd1 = (Z3_ast *)malloc((pathLength+1)*sizeof(Z3_ast));
 	int indiceTabAnd1 = 0;
 	for(int pos=0; pos<pathLength; pos++)
 	{
 		int sizeTabAnd2= 0;
 		while(nodeTab[pos][sizeTabAnd2] != -1)
 			sizeTabAnd2+= 1;
-		Z3_ast tabAnd2[sizeTabAnd2];
+		Z3_ast *tabAnd2 = (Z3_ast *)malloc((sizeTabAnd2+1)*sizeof(Z3_ast));
 		int indiceTabAnd2 = 0;
 
 		for(int i=0; i<sizeTabAnd2; i++)
 		{
-			int numberNeighbours = 0;
-			int tabNeighbour[orderG(graph)];
-			for(int node=0; node<orderG(graph); node++)
-			{
-				if(isEdge(graph, nodeTab[pos][i], node))
-				{
-					tabNeighbour[numberNeighbours++] = node;
-				}
-			}
-			Z3_ast tabOr[numberNeighbours];
+			int numberNeighbours = numSuccessors(graph, nodeTab[pos][i]);
+			int *tabNeighbour = getSuccessors(graph, nodeTab[pos][i]);
+			Z3_ast *tabOr = (Z3_ast *)malloc((numberNeighbours+1)*sizeof(Z3_ast));
 			unsigned int indiceTabOr = 0;
 
 			Z3_ast var = getNodeVariable(ctx, number, pos, pathLength, nodeTab[pos][i]);
@@ -476,20 +1110,69 @@ Z3_ast makePathFormula(Z3_context ctx, Graph graph, int number, int pathLength,
 			
 			for(int k=0; k<numberNeighbours; k++)
 			{
-				Z3_ast var = getNodeVariable(ctx, number, pos+1, pathLength, tabNeighbour[k]);
+				int next = pos + successorWeight(graph, nodeTab[pos][i], k);
+				if(next > pathLength)
+					continue;
+				Z3_ast var = getNodeVariable(ctx, number, next, pathLength, tabNeighbour[k]);
 				tabOr[indiceTabOr++] = var;
 			}
 
-			tabAnd2[indiceTabAnd2++] = Z3_mk_or(ctx, numberNeighbours+1, tabOr);
+			tabAnd2[indiceTabAnd2++] = Z3_mk_or(ctx, indiceTabOr, tabOr);
+			free(tabOr);
 		}
 		tabAnd1[indiceTabAnd1++] = Z3_mk_and(ctx, sizeTabAnd2, tabAnd2);
+		free(tabAnd2);
 	}
 	
 	Z3_ast formula = Z3_mk_and(ctx, pathLength, tabAnd1);
+	free(tabAnd1);
 
 	return formula;
 }
 
+Z3_ast makeMandatoryFormula(Z3_context ctx, Graph graph, int number, int pathLength, int **nodeTab)
+{
+	int order = orderG(graph);
+	int *mandatory = (int *)malloc(order*sizeof(int));
+	int numMandatory = mandatoryNodes(graph, mandatory);
+	int *fromSource = (int *)malloc(order*sizeof(int));
+	int *toTarget = (int *)malloc(order*sizeof(int));
+	shortestDistances(graph, getSouceNode(graph), true, fromSource);
+	shortestDistances(graph, getTargetNode(graph), false, toTarget);
+
+	Z3_ast *tabAnd = (Z3_ast *)malloc((numMandatory*(pathLength+1)+1)*sizeof(Z3_ast));
+	Z3_ast *tabOr = (Z3_ast *)malloc((pathLength+1)*sizeof(Z3_ast));
+	int indiceTabAnd = 0;
+	for(int i=0; i<numMandatory; i++)
+	{
+		int node = mandatory[i];
+		int first = fromSource[node], last = pathLength - toTarget[node];
+		int indiceTabOr = 0;
+		for(int pos=0; pos<=pathLength; pos++)
+		{
+			bool candidate = false;
+			for(int j=0; nodeTab[pos][j] != -1 && !candidate; j++)
+				candidate = nodeTab[pos][j] == node;
+			if(!candidate)
+				continue;
+			Z3_ast var = getNodeVariable(ctx, number, pos, pathLength, node);
+			if(pos >= first && pos <= last)
+				tabOr[indiceTabOr++] = var;
+			else
+				tabAnd[indiceTabAnd++] = Z3_mk_not(ctx, var);
+		}
+		tabAnd[indiceTabAnd++] = indiceTabOr == 1 ? tabOr[0] : Z3_mk_or(ctx, indiceTabOr, tabOr);
+	}
+	Z3_ast formula = indiceTabAnd > 0 ? Z3_mk_and(ctx, indiceTabAnd, tabAnd) : Z3_mk_true(ctx);
+
+	free(mandatory);
+	free(fromSource);
+	free(toTarget);
+	free(tabAnd);
+	free(tabOr);
+	return formula;
+}
+
 Z3_ast makeAnd(Z3_context ctx,Z3_ast formula1, Z3_ast formula2)
 {
 	Z3_ast tabFormula[2] = {formula1, formula2};
@@ -497,143 +1180,346 @@ Z3_ast makeAnd(Z3_context ctx,Z3_ast formula1, Z3_ast formula2)
 	return formula;
 }
 
-Z3_ast optimizeAndMakeFormula(Graph graph, Z3_context ctx, int number, int pathLength)
+int **getPossibleNodes(Graph graph, int pathLength)
 {
-	int possibilities[pathLength+1][MAX_ORDER_G];
-	int fathers[orderG(graph)][orderG(graph)];
+	int order = orderG(graph);
+	int **possibilities = (int **)malloc((pathLength+1)*sizeof(int *));
 
 	if(OPTIMIZE){
+		/*
+		* the possible nodes at a position are the ones reachable from the source with edges whose lengths add up to that position.
+		* Positions are handled in increasing order, each node of a position adding its successors at the position reached through the edge between them.
+		* lastPosition[node] is the last position at which node has been kept, so that duplicates are removed when a position is handled.
+		*/
+		int *sizes = (int *)calloc(pathLength+1, sizeof(int));
+		int *capacities = (int *)malloc((pathLength+1)*sizeof(int));
+		int *lastPosition = (int *)malloc(order*sizeof(int));
+		for(int i=0; i<order; i++)
+			lastPosition[i] = -1;
 		for(int i=0; i<=pathLength; i++)
 		{
-			for(int j=0; j<MAX_ORDER_G; j++)
-			{
-				possibilities[i][j] = -1;
-			}
+			capacities[i] = order+1;
+			possibilities[i] = (int *)malloc(capacities[i]*sizeof(int));
 		}
 
-		for(int i=0; i<orderG(graph); i++)
+		possibilities[0][sizes[0]++] = getSouceNode(graph);
+		for(int pos=0; pos<=pathLength; pos++)
 		{
-			for(int j=0; j<orderG(graph); j++)
+			int kept = 0;
+			for(int i=0; i<sizes[pos]; i++)
 			{
-				fathers[i][j] = -1;
-			}
-		}
-
-		File_t file;
-		file.currentPos = 0;
-
-		fileElement_t element = {getSouceNode(graph), 0};
-		push(&file, element);
-
-		while(!isEmpty(&file))
-		{
-			fileElement_t element = top(&file);
-			if(element.position > pathLength)
-				break;
-
-			int exist = 0;
-			for(int i=0; i<orderG(graph); i++){
-				if(possibilities[element.position][i] == element.node)
+				int node = possibilities[pos][i];
+				if(lastPosition[node] == pos)
+					continue;
+				lastPosition[node] = pos;
+				possibilities[pos][kept++] = node;
+
+				int *successors = getSuccessors(graph, node);
+				for(int j=0; j<numSuccessors(graph, node); j++)
 				{
-					exist = 1;	
-					break;
-				}
-				if(possibilities[element.position][i] == -1){
-					possibilities[element.position][i] = element.node;
-					break;
-				}
-			}
-			if(exist == 0){
-				for(int neighbour=0; neighbour<orderG(graph); neighbour++)
-				{
-					if(isEdge(graph, element.node, neighbour) && (neighbour != element.node))
+					int next = pos + successorWeight(graph, node, j);
+					if(successors[j] == node || next > pathLength)
+						continue;
+					if(sizes[next] == capacities[next])
 					{
-						fileElement_t newElement = {neighbour, element.position + 1};
-						push(&file, newElement);	
+						capacities[next] *= 2;
+						possibilities[next] = (int *)realloc(possibilities[next], capacities[next]*sizeof(int));
 					}
+					possibilities[next][sizes[next]++] = successors[j];
 				}
 			}
-			pull(&file);
+			possibilities[pos][kept] = -1;
 		}
+		free(sizes);
+		free(capacities);
+		free(lastPosition);
 	}else{
 		for(int i=0; i<=pathLength; i++)
 		{
-			for(int j=0; j<MAX_ORDER_G; j++)
-			{
-				if(j<orderG(graph))
-					possibilities[i][j] = j;
-				else
-					possibilities[i][j] = -1;
-			}
+			possibilities[i] = (int *)malloc((order+1)*sizeof(int));
+			for(int j=0; j<order; j++)
+				possibilities[i][j] = j;
+			possibilities[i][order] = -1;
 		}
 	}
+	return possibilities;
+}
+
+void deletePossibleNodes(int **possibilities, int pathLength)
+{
+	for(int i=0; i<=pathLength; i++)
+		free(possibilities[i]);
+	free(possibilities);
+}
+
+int countPathVariables(Graph graph, int pathLength)
+{
+	int **possibilities = getPossibleNodes(graph, pathLength);
+	int count = 0;
+	for(int pos=0; pos<=pathLength; pos++)
+		for(int i=0; possibilities[pos][i] != -1; i++)
+			count++;
+	deletePossibleNodes(possibilities, pathLength);
+	return count;
+}
+
+Z3_ast optimizeAndMakeFormula(Graph graph, Z3_context ctx, int number, int pathLength)
+{
+	int **possibilities = getPossibleNodes(graph, pathLength);
 
 	Z3_ast formulaValide = makeValidFormula(ctx, graph, number, pathLength);
-	Z3_ast formulaSimple = makeSimpleFormula(ctx, graph, number, pathLength, possibilities);
+	Z3_ast formulaSimple = makeSimpleFormula(ctx, graph, number, pathLength, possibilities, true);
 	Z3_ast formulaPath = makePathFormula(ctx, graph, number, pathLength, possibilities); 
 	Z3_ast formula = makeAnd(ctx, formulaValide, formulaSimple); 
 	formula = makeAnd(ctx, formulaPath, formula);
+	if(MANDATORY_NODES)
+		formula = makeAnd(ctx, makeMandatoryFormula(ctx, graph, number, pathLength, possibilities), formula);
+
+	deletePossibleNodes(possibilities, pathLength);
 
 	return formula;
 }
 
-bool isEmpty(File_t *file)
+Z3_ast makeOneHotFormula(Z3_context ctx, Graph graph, int number, int pathLength)
 {
-	return file->currentPos == 0;
+	return optimizeAndMakeFormula(graph, ctx, number, pathLength);
 }
 
-fileElement_t top(File_t* file)
+Z3_ast makeSuccessorFormula(Z3_context ctx, Graph graph, int number, int pathLength)
 {
-	fileElement_t element;
-	if(!isEmpty(file))
-		element = file->tab[0];
-	else{
-		fprintf(stderr, "error: you can't call 'top' in an empty file\n");
-		exit(EXIT_FAILURE);
-	}
-	return element;
+	int order = orderG(graph);
+	int source = getSouceNode(graph);
+	int target = getTargetNode(graph);
+	if(source == target)
+		return pathLength == 0 ? Z3_mk_true(ctx) : Z3_mk_false(ctx);
 
-}
+	/*
+	* a node can only be at a position between its distance from the source and the length minus its distance to the target:
+	* these bounds are given to the solver, and the edges that cannot fit between them are removed
+	*/
+	int *fromSource = (int *)malloc((order+1)*sizeof(int));
+	int *toTarget = (int *)malloc((order+1)*sizeof(int));
+	shortestDistances(graph, source, true, fromSource);
+	shortestDistances(graph, target, false, toTarget);
+
+	/* six clauses for each node, two for each edge and the positions of the source and the target */
+	Z3_ast *clauses = (Z3_ast *)malloc((6*order + 2*sizeG(graph) + 2)*sizeof(Z3_ast));
+	Z3_ast *tabOut = (Z3_ast *)malloc((sizeG(graph)+1)*sizeof(Z3_ast));
+	Z3_ast *tabIn = (Z3_ast *)malloc((sizeG(graph)+1)*sizeof(Z3_ast));
+	Z3_sort intSort = Z3_mk_int_sort(ctx);
+	int numClauses = 0;
+
+	for(int node=0; node<order; node++)
+	{
+		int *successors = getSuccessors(graph, node);
+		int *predecessors = getPredecessors(graph, node);
+		for(int j=0; j<numSuccessors(graph, node); j++)
+			tabOut[j] = getEdgeVariable(ctx, number, pathLength, node, successors[j]);
+		for(int j=0; j<numPredecessors(graph, node); j++)
+			tabIn[j] = getEdgeVariable(ctx, number, pathLength, predecessors[j], node);
+		Z3_ast anyOut = Z3_mk_or(ctx, numSuccessors(graph, node), tabOut);
+		Z3_ast anyIn = Z3_mk_or(ctx, numPredecessors(graph, node), tabIn);
+
+		/* the path leaves the source and enters the target once, and crosses the other nodes at most once */
+		clauses[numClauses++] = Z3_mk_atmost(ctx, numSuccessors(graph, node), tabOut, 1);
+		clauses[numClauses++] = Z3_mk_atmost(ctx, numPredecessors(graph, node), tabIn, 1);
+		if(node == source)
+		{
+			clauses[numClauses++] = anyOut;
+			clauses[numClauses++] = Z3_mk_not(ctx, anyIn);
+		}
+		else if(node == target)
+		{
+			clauses[numClauses++] = anyIn;
+			clauses[numClauses++] = Z3_mk_not(ctx, anyOut);
+		}
+		else
+			clauses[numClauses++] = Z3_mk_iff(ctx, anyIn, anyOut);
 
-fileElement_t pull(File_t *file)
-{
-	fileElement_t element;
-	if(!isEmpty(file))
-		element = file->tab[0];
-	else{
-		fprintf(stderr, "error: you can't call 'pull' in an empty file\n");
-		exit(EXIT_FAILURE);
+		/* ordering: the target of a chosen edge is further than its source by the length of the edge */
+		Z3_ast position = getOrderVariable(ctx, number, pathLength, node);
+		bool usable = fromSource[node] != -1 && toTarget[node] != -1 && fromSource[node] <= pathLength - toTarget[node];
+		if(usable)
+		{
+			clauses[numClauses++] = Z3_mk_ge(ctx, position, Z3_mk_int(ctx, fromSource[node], intSort));
+			clauses[numClauses++] = Z3_mk_le(ctx, position, Z3_mk_int(ctx, pathLength - toTarget[node], intSort));
+		}
+		for(int j=0; j<numSuccessors(graph, node); j++)
+		{
+			int weight = successorWeight(graph, node, j);
+			int next = successors[j];
+			if(!usable || toTarget[next] == -1 || fromSource[node] + weight > pathLength - toTarget[next])
+			{
+				clauses[numClauses++] = Z3_mk_not(ctx, tabOut[j]);
+				continue;
+			}
+			Z3_ast sum[2] = {position, Z3_mk_int(ctx, weight, intSort)};
+			clauses[numClauses++] = Z3_mk_implies(ctx, tabOut[j], Z3_mk_eq(ctx, getOrderVariable(ctx, number, pathLength, next), Z3_mk_add(ctx, 2, sum)));
+		}
 	}
-	for(int i=1; i<file->currentPos; i++)
-		file->tab[i-1] = file->tab[i];
-	file->currentPos -= 1;
-	return element;
+	clauses[numClauses++] = Z3_mk_eq(ctx, getOrderVariable(ctx, number, pathLength, source), Z3_mk_int(ctx, 0, intSort));
+	clauses[numClauses++] = Z3_mk_eq(ctx, getOrderVariable(ctx, number, pathLength, target), Z3_mk_int(ctx, pathLength, intSort));
+
+	Z3_ast formula = Z3_mk_and(ctx, numClauses, clauses);
+	free(fromSource);
+	free(toTarget);
+	free(clauses);
+	free(tabOut);
+	free(tabIn);
+	return formula;
 }
 
-void push(File_t *file, fileElement_t element)
+Z3_ast makeLogFormula(Z3_context ctx, Graph graph, int number, int pathLength)
 {
-	if(file->currentPos<FILE_SIZE)
-		file->tab[file->currentPos] = element;
+	int order = orderG(graph);
+	bool weighted = graph.weights != NULL;
+
+	/* nodes are written with enough bits for the codes 0 to order, the code order meaning that no node is at the position (inside a longer edge) */
+	unsigned int size = 1;
+	while((1u << size) <= (unsigned int)order)
+		size++;
+	Z3_sort sort = Z3_mk_bv_sort(ctx, size);
+	Z3_ast *codes = (Z3_ast *)malloc((order+1)*sizeof(Z3_ast));
+	for(int node=0; node<=order; node++)
+		codes[node] = Z3_mk_unsigned_int(ctx, node, sort);
+	Z3_ast *positions = (Z3_ast *)malloc((pathLength+1)*sizeof(Z3_ast));
+	for(int pos=0; pos<=pathLength; pos++)
+		positions[pos] = getLogPositionVariable(ctx, number, pathLength, pos, size);
+
+	int **possibilities = getPossibleNodes(graph, pathLength);
+	int numPairs = 0;
+	for(int pos=0; pos<=pathLength; pos++)
+		for(int i=0; possibilities[pos][i] != -1; i++)
+			numPairs++;
+
+	/* an implication for each pair (node, position), the possible nodes of each position, the ends and the simplicity of the path */
+	int numDifferences = weighted ? (pathLength+1)*pathLength/2 : 1;
+	Z3_ast *clauses = (Z3_ast *)malloc((numPairs + pathLength + numDifferences + 3)*sizeof(Z3_ast));
+	Z3_ast *tabOr = (Z3_ast *)malloc((order + sizeG(graph) + 2)*sizeof(Z3_ast));
+	int numClauses = 0;
+	clauses[numClauses++] = Z3_mk_eq(ctx, positions[0], codes[getSouceNode(graph)]);
+	clauses[numClauses++] = Z3_mk_eq(ctx, positions[pathLength], codes[getTargetNode(graph)]);
+
+	for(int pos=0; pos<=pathLength; pos++)
+	{
+		int sizeTabOr = 0;
+		for(int i=0; possibilities[pos][i] != -1; i++)
+			tabOr[sizeTabOr++] = Z3_mk_eq(ctx, positions[pos], codes[possibilities[pos][i]]);
+		if(weighted)
+			tabOr[sizeTabOr++] = Z3_mk_eq(ctx, positions[pos], codes[order]);
+		clauses[numClauses++] = Z3_mk_or(ctx, sizeTabOr, tabOr);
+
+		for(int i=0; possibilities[pos][i] != -1 && pos < pathLength; i++)
+		{
+			int node = possibilities[pos][i];
+			int *successors = getSuccessors(graph, node);
+			sizeTabOr = 0;
+			for(int j=0; j<numSuccessors(graph, node); j++)
+			{
+				int next = pos + successorWeight(graph, node, j);
+				if(next <= pathLength)
+					tabOr[sizeTabOr++] = Z3_mk_eq(ctx, positions[next], codes[successors[j]]);
+			}
+			clauses[numClauses++] = Z3_mk_implies(ctx, Z3_mk_eq(ctx, positions[pos], codes[node]), Z3_mk_or(ctx, sizeTabOr, tabOr));
+		}
+	}
+
+	/* simplicity: all positions hold different nodes, except the positions inside longer edges */
+	if(!weighted)
+		clauses[numClauses++] = Z3_mk_distinct(ctx, pathLength+1, positions);
 	else
 	{
-		printf("Erreur: full file\n");
-		exit(EXIT_FAILURE);
+		for(int pos=0; pos<=pathLength; pos++)
+		{
+			for(int other=pos+1; other<=pathLength; other++)
+			{
+				Z3_ast different[2] = {Z3_mk_eq(ctx, positions[pos], codes[order]), Z3_mk_not(ctx, Z3_mk_eq(ctx, positions[pos], positions[other]))};
+				clauses[numClauses++] = Z3_mk_or(ctx, 2, different);
+			}
+		}
 	}
-	file->currentPos += 1;
+
+	Z3_ast formula = Z3_mk_and(ctx, numClauses, clauses);
+	deletePossibleNodes(possibilities, pathLength);
+	free(codes);
+	free(positions);
+	free(clauses);
+	free(tabOr);
+	return formula;
 }
 
-void printFile(File_t *file)
+Z3_ast makeSharedFormula(Z3_context ctx, Graph graph, int number, int maxLength)
 {
-	for(int i=0; i<file->currentPos; i++)
+	int order = orderG(graph);
+	int target = getTargetNode(graph);
+	int **possibilities = getPossibleNodes(graph, maxLength);
+	int numPairs = 0;
+	for(int pos=0; pos<=maxLength; pos++)
+		for(int i=0; possibilities[pos][i] != -1; i++)
+			numPairs++;
+
+	/* at most five clauses for each pair (node, position), and one for each position */
+	Z3_ast *clauses = (Z3_ast *)malloc((5*numPairs + maxLength + 2)*sizeof(Z3_ast));
+	Z3_ast *tabOr = (Z3_ast *)malloc((sizeG(graph)+1)*sizeof(Z3_ast));
+	int *lastPosition = (int *)malloc((order+1)*sizeof(int));
+	for(int node=0; node<order; node++)
+		lastPosition[node] = -1;
+	int numClauses = 0;
+	clauses[numClauses++] = getNodeVariable(ctx, number, 0, ANY_LENGTH, getSouceNode(graph));
+
+	for(int pos=0; pos<=maxLength; pos++)
 	{
-		printf(" %d", file->tab[i]);
-	}
-	printf("\n");
-	if(file->currentPos == 0)
-		printf("empty file\n");
-}
+		bool targetPossible = false;
+		for(int i=0; possibilities[pos][i] != -1; i++)
+		{
+			int node = possibilities[pos][i];
+			Z3_ast var = getNodeVariable(ctx, number, pos, ANY_LENGTH, node);
 
+			/* the target is reached at the selected length, the other nodes are followed by one of their successors */
+			if(node == target)
+			{
+				targetPossible = true;
+				clauses[numClauses++] = Z3_mk_iff(ctx, var, getLengthVariable(ctx, pos));
+			}
+			else
+			{
+				int *successors = getSuccessors(graph, node);
+				int sizeTabOr = 0;
+				for(int j=0; j<numSuccessors(graph, node); j++)
+				{
+					int next = pos + successorWeight(graph, node, j);
+					if(next <= maxLength)
+						tabOr[sizeTabOr++] = getNodeVariable(ctx, number, next, ANY_LENGTH, successors[j]);
+				}
+				clauses[numClauses++] = Z3_mk_implies(ctx, var, Z3_mk_or(ctx, sizeTabOr, tabOr));
+			}
+
+			/* no node after the end of the path */
+			if(pos > 0)
+				clauses[numClauses++] = Z3_mk_implies(ctx, getEndedVariable(ctx, pos), Z3_mk_not(ctx, var));
+
+			/* a node is used at most once: its "used" variable at a position is true if it is at this position or before */
+			Z3_ast used = getUsedVariable(ctx, number, pos, node);
+			clauses[numClauses++] = Z3_mk_implies(ctx, var, used);
+			if(lastPosition[node] != -1)
+			{
+				Z3_ast usedBefore = getUsedVariable(ctx, number, lastPosition[node], node);
+				clauses[numClauses++] = Z3_mk_implies(ctx, usedBefore, used);
+				clauses[numClauses++] = Z3_mk_implies(ctx, usedBefore, Z3_mk_not(ctx, var));
+			}
+			lastPosition[node] = pos;
+		}
+		if(!targetPossible)
+			clauses[numClauses++] = Z3_mk_not(ctx, getLengthVariable(ctx, pos));
+	}
 
+	Z3_ast formula = Z3_mk_and(ctx, numClauses, clauses);
+	deletePossibleNodes(possibilities, maxLength);
+	free(clauses);
+	free(tabOr);
+	free(lastPosition);
+	return formula;
+}
 
 int getSouceNode(Graph graphe)
 {
@@ -3,6 +3,61 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#define HINT_ROUNDS 3	// number of checks under hints in \ref solveFormulaWithHints before solving without them
+#define MAX_SOLVER_PARAMS 32	// number of parameters \ref addSolverParam can keep
+#define MAX_SETTING_SIZE 256	// the longest kind of solver or parameter setting kept
+
+unsigned int numSolverCalls = 0;	// incremented by each function calling the solver
+unsigned int solverTimeout = 0;	// milliseconds given to each check (0: no limit)
+bool hasDeadline = false;		// true if the checks must end before \ref deadline
+struct timespec deadline;		// the moment after which the solver is not called anymore
+char solverKind[MAX_SETTING_SIZE] = "default";	// the solver built by \ref makeSolver: "default", "simple" or tactics separated by commas
+char paramNames[MAX_SOLVER_PARAMS][MAX_SETTING_SIZE];	// the parameters given to each solver, by \ref addSolverParam
+char paramValues[MAX_SOLVER_PARAMS][MAX_SETTING_SIZE];	// their values
+Z3_param_kind paramKinds[MAX_SOLVER_PARAMS];		// their types
+unsigned int numParams = 0;
+
+/**
+ * @brief Gives to @p solver the time left for its next check, according to \ref setSolverTimeout and \ref setSolverDeadline.
+ * 
+ * @param ctx The context of the solver.
+ * @param solver The solver.
+ * @return bool false if the deadline is passed, in which case the check must not be done.
+ */
+bool limitCheck(Z3_context ctx, Z3_solver solver);
+
+/**
+ * @brief Builds the tactic of a kind of solver, the tactics named being applied one after the other.
+ * 
+ * @param ctx The context of the solver.
+ * @param kind The names of the tactics, separated by commas.
+ * @return Z3_tactic The tactic, to free with Z3_tactic_dec_ref.
+ */
+Z3_tactic makeTactic(Z3_context ctx, const char *kind);
+
+/**
+ * @brief Builds a solver of a kind, without any parameter.
+ * 
+ * @param ctx The context of the solver.
+ * @param kind The kind of solver, as given to \ref setSolverKind.
+ * @return Z3_solver The solver, already referenced: to free with Z3_solver_dec_ref.
+ */
+Z3_solver makeSolverOfKind(Z3_context ctx, const char *kind);
+
+/**
+ * @brief Checks a parameter against the parameters of a kind of solver.
+ * 
+ * @param ctx The context of the solver.
+ * @param kind The kind of solver.
+ * @param name The name of the parameter.
+ * @param value Its value.
+ * @param type Filled with its type if it is valid.
+ * @return bool false if the solver has no such parameter or if the value does not fit its type.
+ */
+bool checkSolverParam(Z3_context ctx, const char *kind, const char *name, const char *value, Z3_param_kind *type);
 
 Z3_context makeContext(void) {
     Z3_config config = Z3_mk_config();
@@ -23,23 +78,317 @@ Z3_ast mk_bool_var(Z3_context ctx, const char * name)
     return mk_var(ctx, name, ty);
 }
 
+Z3_ast mk_int_var(Z3_context ctx, const char * name)
+{
+    Z3_sort ty = Z3_mk_int_sort(ctx);
+    return mk_var(ctx, name, ty);
+}
+
+Z3_ast mk_bv_var(Z3_context ctx, const char * name, unsigned int size)
+{
+    Z3_sort ty = Z3_mk_bv_sort(ctx, size);
+    return mk_var(ctx, name, ty);
+}
+
+unsigned int getNumSolverCalls(void)
+{
+    return numSolverCalls;
+}
+
+bool setSolverKind(Z3_context ctx, const char *kind)
+{
+    if (strlen(kind) >= MAX_SETTING_SIZE || kind[0] == '\0')
+        return false;
+    if (strcmp(kind, "default") != 0 && strcmp(kind, "simple") != 0) {
+        if (kind[0] == ',' || kind[strlen(kind)-1] == ',' || strstr(kind, ",,") != NULL)
+            return false;
+        /* each tactic must exist, Z3 exits on an unknown one */
+        char names[MAX_SETTING_SIZE];
+        strcpy(names, kind);
+        for (char *name = strtok(names, ","); name != NULL; name = strtok(NULL, ",")) {
+            bool known = false;
+            for (unsigned int i = 0; i < Z3_get_num_tactics(ctx) && !known; i++)
+                known = strcmp(Z3_get_tactic_name(ctx, i), name) == 0;
+            if (!known)
+                return false;
+        }
+    }
+    /* the parameters given before are kept, so they must fit the new kind */
+    Z3_param_kind kinds[MAX_SOLVER_PARAMS];
+    for (unsigned int i = 0; i < numParams; i++) {
+        if (!checkSolverParam(ctx, kind, paramNames[i], paramValues[i], &kinds[i]))
+            return false;
+    }
+    for (unsigned int i = 0; i < numParams; i++)
+        paramKinds[i] = kinds[i];
+    strcpy(solverKind, kind);
+    return true;
+}
+
+const char *getSolverKind(void)
+{
+    return solverKind;
+}
+
+bool addSolverParam(Z3_context ctx, const char *setting)
+{
+    const char *equal = strchr(setting, '=');
+    if (equal == NULL || equal == setting || equal[1] == '\0' || strlen(setting) >= MAX_SETTING_SIZE || numParams == MAX_SOLVER_PARAMS)
+        return false;
+    char *name = paramNames[numParams], *value = paramValues[numParams];
+    strncpy(name, setting, equal - setting);
+    name[equal - setting] = '\0';
+    strcpy(value, equal + 1);
+    if (!checkSolverParam(ctx, solverKind, name, value, &paramKinds[numParams]))
+        return false;
+    numParams++;
+    return true;
+}
+
+bool checkSolverParam(Z3_context ctx, const char *kind, const char *name, const char *value, Z3_param_kind *type)
+{
+    /* the name and the value are checked against the parameters of the solver built, Z3 exits on a wrong one */
+    Z3_solver solver = makeSolverOfKind(ctx, kind);
+    Z3_param_descrs descriptions = Z3_solver_get_param_descrs(ctx, solver);
+    Z3_param_descrs_inc_ref(ctx, descriptions);
+    *type = Z3_param_descrs_get_kind(ctx, descriptions, Z3_mk_string_symbol(ctx, name));
+    Z3_param_descrs_dec_ref(ctx, descriptions);
+    Z3_solver_dec_ref(ctx, solver);
+    char *end;
+    bool valid;
+    switch (*type) {
+    case Z3_PK_UINT:
+        strtoul(value, &end, 10);
+        valid = *end == '\0' && value[0] != '-';
+        break;
+    case Z3_PK_DOUBLE:
+        strtod(value, &end);
+        valid = *end == '\0';
+        break;
+    case Z3_PK_BOOL:
+        valid = strcmp(value, "true") == 0 || strcmp(value, "false") == 0;
+        break;
+    case Z3_PK_SYMBOL:
+    case Z3_PK_STRING:
+        valid = true;
+        break;
+    default:
+        valid = false;
+    }
+    return valid;
+}
+
+Z3_tactic makeTactic(Z3_context ctx, const char *kind)
+{
+    char names[MAX_SETTING_SIZE];
+    strcpy(names, kind);
+    Z3_tactic tactic = NULL;
+    for (char *name = strtok(names, ","); name != NULL; name = strtok(NULL, ",")) {
+        Z3_tactic next = Z3_mk_tactic(ctx, name);
+        Z3_tactic_inc_ref(ctx, next);
+        if (tactic != NULL) {
+            Z3_tactic both = Z3_tactic_and_then(ctx, tactic, next);
+            Z3_tactic_inc_ref(ctx, both);
+            Z3_tactic_dec_ref(ctx, tactic);
+            Z3_tactic_dec_ref(ctx, next);
+            next = both;
+        }
+        tactic = next;
+    }
+    return tactic;
+}
+
+Z3_solver makeSolverOfKind(Z3_context ctx, const char *kind)
+{
+    Z3_solver solver;
+    if (strcmp(kind, "default") == 0)
+        solver = Z3_mk_solver(ctx);
+    else if (strcmp(kind, "simple") == 0)
+        solver = Z3_mk_simple_solver(ctx);
+    else {
+        Z3_tactic tactic = makeTactic(ctx, kind);
+        solver = Z3_mk_solver_from_tactic(ctx, tactic);
+        Z3_tactic_dec_ref(ctx, tactic);
+    }
+    Z3_solver_inc_ref(ctx, solver);
+    return solver;
+}
+
+Z3_solver makeSolver(Z3_context ctx)
+{
+    Z3_solver solver = makeSolverOfKind(ctx, solverKind);
+    if (numParams > 0) {
+        Z3_params params = Z3_mk_params(ctx);
+        Z3_params_inc_ref(ctx, params);
+        for (unsigned int i = 0; i < numParams; i++) {
+            Z3_symbol name = Z3_mk_string_symbol(ctx, paramNames[i]);
+            switch (paramKinds[i]) {
+            case Z3_PK_UINT:
+                Z3_params_set_uint(ctx, params, name, strtoul(paramValues[i], NULL, 10));
+                break;
+            case Z3_PK_DOUBLE:
+                Z3_params_set_double(ctx, params, name, strtod(paramValues[i], NULL));
+                break;
+            case Z3_PK_BOOL:
+                Z3_params_set_bool(ctx, params, name, strcmp(paramValues[i], "true") == 0);
+                break;
+            default:
+                Z3_params_set_symbol(ctx, params, name, Z3_mk_string_symbol(ctx, paramValues[i]));
+            }
+        }
+        Z3_solver_set_params(ctx, solver, params);
+        Z3_params_dec_ref(ctx, params);
+    }
+    return solver;
+}
+
+void setSolverTimeout(unsigned int milliseconds)
+{
+    solverTimeout = milliseconds;
+}
+
+unsigned int getSolverTimeout(void)
+{
+    return solverTimeout;
+}
+
+void setSolverDeadline(unsigned int milliseconds)
+{
+    hasDeadline = milliseconds > 0;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += milliseconds / 1000;
+    deadline.tv_nsec += (long)(milliseconds % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+}
+
+bool isDeadlinePassed(void)
+{
+    if (!hasDeadline)
+        return false;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec > deadline.tv_sec || (now.tv_sec == deadline.tv_sec && now.tv_nsec >= deadline.tv_nsec);
+}
+
+bool limitCheck(Z3_context ctx, Z3_solver solver)
+{
+    unsigned int limit = solverTimeout;
+    if (hasDeadline) {
+        if (isDeadlinePassed())
+            return false;
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long long left = (long long)(deadline.tv_sec - now.tv_sec) * 1000 + (deadline.tv_nsec - now.tv_nsec) / 1000000;
+        if (left < 1)
+            left = 1;
+        if (limit == 0 || left < limit)
+            limit = (unsigned int)left;
+    }
+    if (limit > 0) {
+        Z3_params params = Z3_mk_params(ctx);
+        Z3_params_inc_ref(ctx, params);
+        Z3_params_set_uint(ctx, params, Z3_mk_string_symbol(ctx, "timeout"), limit);
+        Z3_solver_set_params(ctx, solver, params);
+        Z3_params_dec_ref(ctx, params);
+    }
+    return true;
+}
+
 Z3_lbool isFormulaSat(Z3_context ctx, Z3_ast formula){
-    Z3_solver s = Z3_mk_solver(ctx);
-    Z3_solver_inc_ref(ctx, s);
+    numSolverCalls++;
+    Z3_solver s = makeSolver(ctx);
     Z3_solver_assert(ctx,s,formula);
 
-    Z3_lbool result =  Z3_solver_check(ctx, s);
+    Z3_lbool result = limitCheck(ctx, s) ? Z3_solver_check(ctx, s) : Z3_L_UNDEF;
     Z3_solver_dec_ref(ctx, s);
     return result;
 }
 
+Z3_lbool solveFormula(Z3_context ctx, Z3_ast formula, Z3_model *model){
+    numSolverCalls++;
+    Z3_solver s = makeSolver(ctx);
+    Z3_solver_assert(ctx,s,formula);
+
+    Z3_lbool result = limitCheck(ctx, s) ? Z3_solver_check(ctx, s) : Z3_L_UNDEF;
+    *model = 0;
+    if (result == Z3_L_TRUE) {
+        *model = Z3_solver_get_model(ctx, s);
+        if (*model) Z3_model_inc_ref(ctx, *model);
+    }
+    Z3_solver_dec_ref(ctx, s);
+    return result;
+}
+
+Z3_lbool solveFormulaWithHints(Z3_context ctx, Z3_ast formula, Z3_ast *hints, unsigned int numHints, Z3_model *model){
+    Z3_solver s = makeSolver(ctx);
+    Z3_solver_assert(ctx,s,formula);
+
+    Z3_lbool result = Z3_L_UNDEF;
+    bool decided = false;
+    for (int round = 0; round < HINT_ROUNDS && numHints > 0 && !decided; round++) {
+        numSolverCalls++;
+        result = limitCheck(ctx, s) ? Z3_solver_check_assumptions(ctx, s, numHints, hints) : Z3_L_UNDEF;
+        if (result != Z3_L_FALSE) {
+            decided = true;
+            break;
+        }
+        /* the hints in the core contradict the formula, the others are kept (an empty core means the formula itself is unsatisfiable,
+           except for a solver built from tactics, which gives no core: all hints are then dropped) */
+        Z3_ast_vector core = Z3_solver_get_unsat_core(ctx, s);
+        Z3_ast_vector_inc_ref(ctx, core);
+        unsigned int coreSize = Z3_ast_vector_size(ctx, core);
+        bool fromTactics = strcmp(solverKind, "default") != 0 && strcmp(solverKind, "simple") != 0;
+        decided = coreSize == 0 && !fromTactics;
+        if (coreSize == 0 && fromTactics)
+            numHints = 0;
+        unsigned int kept = 0;
+        for (unsigned int i = 0; i < numHints; i++) {
+            bool inCore = false;
+            for (unsigned int j = 0; j < coreSize && !inCore; j++)
+                inCore = Z3_is_eq_ast(ctx, hints[i], Z3_ast_vector_get(ctx, core, j));
+            if (!inCore)
+                hints[kept++] = hints[i];
+        }
+        numHints = kept;
+        Z3_ast_vector_dec_ref(ctx, core);
+    }
+    if (!decided) {
+        numSolverCalls++;
+        result = limitCheck(ctx, s) ? Z3_solver_check(ctx, s) : Z3_L_UNDEF;
+    }
+
+    *model = 0;
+    if (result == Z3_L_TRUE) {
+        *model = Z3_solver_get_model(ctx, s);
+        if (*model) Z3_model_inc_ref(ctx, *model);
+    }
+    Z3_solver_dec_ref(ctx, s);
+    return result;
+}
+
+Z3_lbool checkWithAssumption(Z3_context ctx, Z3_solver solver, Z3_ast assumption, Z3_model *model){
+    numSolverCalls++;
+    Z3_lbool result = Z3_L_UNDEF;
+    if (limitCheck(ctx, solver))
+        result = (assumption == NULL) ? Z3_solver_check(ctx, solver) : Z3_solver_check_assumptions(ctx, solver, 1, &assumption);
+    *model = 0;
+    if (result == Z3_L_TRUE) {
+        *model = Z3_solver_get_model(ctx, solver);
+        if (*model) Z3_model_inc_ref(ctx, *model);
+    }
+    return result;
+}
+
 Z3_model getModelFromSatFormula(Z3_context ctx, Z3_ast formula){
-    Z3_solver s = Z3_mk_solver(ctx);
-    Z3_solver_inc_ref(ctx, s);
+    numSolverCalls++;
+    Z3_solver s = makeSolver(ctx);
     Z3_solver_assert(ctx,s,formula);
 
     Z3_model m      = 0;
-    Z3_lbool result = Z3_solver_check(ctx, s);
+    Z3_lbool result = limitCheck(ctx, s) ? Z3_solver_check(ctx, s) : Z3_L_UNDEF;
 
     switch (result) {
     case Z3_L_FALSE:
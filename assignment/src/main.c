@@ -9,32 +9,34 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "Graph.h"
 #include "Parsing.h"
+#include "Preprocessing.h"
+#include "Search.h"
+#include "Dynamic.h"
+#include "Cache.h"
+#include "Selection.h"
+#include "Portfolio.h"
+#include "Query.h"
+#include "Server.h"
 #include "Solving.h"
 #include "Z3Tools.h"
 
-bool PRINT_PATH = false;
-bool WRITE_PATH_IN_DOT_FILE = false;
-bool TEST_SEPARATLY_BY_DEEPTH = false; 
-bool TEST_ALL = false;
-bool PRINT_FORMULA = false;
-bool DECREASING_ORDER = false;
-
-
 /**
 * @brief usage print a help to the user of the program
 */
 void usage();
 
 /**
-* @brief findPath find paths by testing formula separatly by depth
-* @param ctx the context of the solver
-* @param graphs all graphs
-* @param numGraphs number of graphs
+* @brief parseLengths reads a set of lengths such as "3,5,10-20", and exits on a malformed set
+* @param spec the set of lengths: lengths or ranges MIN-MAX separated by commas
+* @param numLengths filled with the greatest length of the set + 1
+* @return lengths[k] is true if the length k is in the set, to free
 */
-void findPath( Z3_context ctx, Graph *graphs,unsigned int numGraphs);
+bool *parseLengths(char *spec, int *numLengths);
 
 
 int main(int argc, char* argv[])
@@ -47,6 +49,20 @@ int main(int argc, char* argv[])
 	
     Z3_context context = makeContext();
 	Graph graphs[argc - 1];
+	char *fileNames[argc - 1];
+	char *engines[argc - 1];		// with -R, the options of each engine raced
+	char *arguments[argc];			// the arguments given to each engine with -R, all but those of -R
+	int numArguments = 1;
+	arguments[0] = argv[0];
+	QueryOptions options = defaultQueryOptions();
+	bool printStats = false;		// with -S, displays statistics at the end
+	int loadingThreads = 0;			// with -j, number of threads parsing the files (0: one per processor)
+	int numEngines = 0;				// with -R, number of engines raced by \ref racePortfolio
+	bool answerStatus = false;		// with -x, the exit status tells the answer (EXIT_FOUND, EXIT_NOT_FOUND or EXIT_UNDECIDED)
+	bool serverMode = false;		// with -D, answers the queries read on the standard input, keeping the graphs loaded (see \ref serve in Server.h)
+	char *solverKind = NULL;		// with -k, the kind of solver (see \ref setSolverKind)
+	char *solverParams[argc - 1];	// with -K, the parameters of the solver (see \ref addSolverParam)
+	int numSolverParams = 0;
 
 	int numberGraphs = 0;
 	for(int i=0; i<argc-1; i++)
@@ -61,24 +77,24 @@ int main(int argc, char* argv[])
 			option = true;
 		}
 		if(strcmp("-F", argv[i+1])==0){
-			PRINT_FORMULA = true;
+			options.printFormula = true;
 			option = true;
 		}
 		if(strcmp("-t", argv[i+1])==0){
-			PRINT_PATH = true;
+			options.printPath = true;
 			option = true;
 		}
 		if(strcmp("-f", argv[i+1])==0){
-			WRITE_PATH_IN_DOT_FILE= true;
+			options.writeDotFile= true;
 			option = true;
 		}
 		if(strcmp("-s", argv[i+1])==0){
-			TEST_SEPARATLY_BY_DEEPTH = true;
+			options.separately = true;
 			option = true;
 		}
 		if(strcmp("-a", argv[i+1])==0){
-			if(TEST_SEPARATLY_BY_DEEPTH == true){
-				TEST_ALL= true;
+			if(options.separately == true){
+				options.testAll= true;
 				option = true;
 			}else{
 				fprintf(stderr, "You must use -s before -a\n");
@@ -86,8 +102,8 @@ int main(int argc, char* argv[])
 			}
 		}
 		if(strcmp("-d", argv[i+1])==0){
-			if(TEST_SEPARATLY_BY_DEEPTH == true){
-				DECREASING_ORDER = true;
+			if(options.separately == true){
+				options.decreasingOrder = true;
 				option = true;
 			}else
 			{
@@ -96,34 +112,348 @@ int main(int argc, char* argv[])
 			}
 		}
 
+		if(strcmp("-S", argv[i+1])==0){
+			printStats = true;
+			option = true;
+		}
+		if(strcmp("-x", argv[i+1])==0){
+			answerStatus = true;
+			option = true;
+		}
+
+		if(strcmp("-e", argv[i+1])==0){
+			if(i+2 >= argc){
+				fprintf(stderr, "-e needs an encoding name\n");
+				exit(EXIT_FAILURE);
+			}
+			const PathEncoding *encoding = findPathEncoding(argv[i+2]);
+			if(encoding == NULL){
+				fprintf(stderr, "Unknown encoding %s (use -h to list them)\n", argv[i+2]);
+				exit(EXIT_FAILURE);
+			}
+			setPathEncoding(encoding);
+			i++;
+			option = true;
+		}
+
+		if(strcmp("-M", argv[i+1])==0){
+			options.longest = true;
+			option = true;
+		}
+
+		if(strcmp("-m", argv[i+1])==0){
+			options.shortest = true;
+			option = true;
+		}
+
+		if(strcmp("-u", argv[i+1])==0){
+			options.sharedFormula = true;
+			option = true;
+		}
+
+		if(strcmp("-l", argv[i+1])==0){
+			options.lazySimplicity = true;
+			option = true;
+		}
+
+		if(strcmp("-H", argv[i+1])==0){
+			char *end = NULL;
+			if(i+2 < argc)
+				options.searchBudget = strtoul(argv[i+2], &end, 10);
+			if(end == NULL || end == argv[i+2] || *end != '\0'){
+				fprintf(stderr, "-H needs a number of nodes\n");
+				exit(EXIT_FAILURE);
+			}
+			i++;
+			option = true;
+		}
+
+		if(strcmp("-b", argv[i+1])==0){
+			setBidirectionalSearch(true);
+			option = true;
+		}
+
+		if(strcmp("-p", argv[i+1])==0){
+			char *end = NULL;
+			int numThreads = 0;
+			if(i+2 < argc)
+				numThreads = strtol(argv[i+2], &end, 10);
+			if(end == NULL || end == argv[i+2] || *end != '\0' || numThreads < 1){
+				fprintf(stderr, "-p needs a positive number of threads\n");
+				exit(EXIT_FAILURE);
+			}
+			setSearchThreads(numThreads);
+			i++;
+			option = true;
+		}
+
+		if(strcmp("-B", argv[i+1])==0){
+			char *end = NULL;
+			if(i+2 < argc)
+				options.dynamicNodes = strtol(argv[i+2], &end, 10);
+			if(end == NULL || end == argv[i+2] || *end != '\0' || options.dynamicNodes < 1 || options.dynamicNodes > MAX_DYNAMIC_NODES){
+				fprintf(stderr, "-B needs a number of nodes between 1 and %d\n", MAX_DYNAMIC_NODES);
+				exit(EXIT_FAILURE);
+			}
+			i++;
+			option = true;
+		}
+
+		if(strcmp("-P", argv[i+1])==0){
+			options.seedPhases = true;
+			option = true;
+		}
+
+		if(strcmp("-r", argv[i+1])==0){
+			if(i+2 >= argc){
+				fprintf(stderr, "-r needs a set of lengths\n");
+				exit(EXIT_FAILURE);
+			}
+			free(options.lengths);
+			options.lengths = parseLengths(argv[i+2], &options.numLengths);
+			options.lengthsSpec = argv[i+2];
+			i++;
+			option = true;
+		}
+
+		if(strcmp("-o", argv[i+1])==0){
+			if(i+2 >= argc){
+				fprintf(stderr, "-o needs a file name\n");
+				exit(EXIT_FAILURE);
+			}
+			options.dotFileName = argv[i+2];
+			i++;
+			option = true;
+		}
+
+		if(strcmp("-C", argv[i+1])==0){
+			if(i+2 >= argc){
+				fprintf(stderr, "-C needs a directory\n");
+				exit(EXIT_FAILURE);
+			}
+			options.cacheDirectory = argv[i+2];
+			i++;
+			option = true;
+		}
+
+		if(strcmp("-T", argv[i+1])==0 || strcmp("-L", argv[i+1])==0){
+			char *end = NULL;
+			unsigned long milliseconds = 0;
+			if(i+2 < argc)
+				milliseconds = strtoul(argv[i+2], &end, 10);
+			if(end == NULL || end == argv[i+2] || *end != '\0' || milliseconds == 0){
+				fprintf(stderr, "%s needs a positive number of milliseconds\n", argv[i+1]);
+				exit(EXIT_FAILURE);
+			}
+			if(strcmp("-T", argv[i+1])==0)
+				options.solverTimeout = milliseconds;
+			else
+				options.timeLimit = milliseconds;
+			i++;
+			option = true;
+		}
+
+		if(strcmp("-k", argv[i+1])==0 || strcmp("-K", argv[i+1])==0){
+			if(i+2 >= argc){
+				fprintf(stderr, "%s needs %s\n", argv[i+1], strcmp("-k", argv[i+1])==0 ? "a kind of solver" : "a parameter NAME=VALUE");
+				exit(EXIT_FAILURE);
+			}
+			if(strcmp("-k", argv[i+1])==0)
+				solverKind = argv[i+2];
+			else
+				solverParams[numSolverParams++] = argv[i+2];
+			i++;
+			option = true;
+		}
+
+		if(strcmp("-R", argv[i+1])==0){
+			if(i+2 >= argc){
+				fprintf(stderr, "-R needs the options of an engine\n");
+				exit(EXIT_FAILURE);
+			}
+			engines[numEngines++] = argv[i+2];
+			i++;
+			continue;
+		}
+
+		if(strcmp("-A", argv[i+1])==0){
+			options.automaticEngine = true;
+			option = true;
+		}
+
+		if(strcmp("-c", argv[i+1])==0){
+			if(i+2 >= argc){
+				fprintf(stderr, "-c needs the file of a cost model\n");
+				exit(EXIT_FAILURE);
+			}
+			options.costModel = readCostModel(argv[i+2], defaultCostModel());
+			options.automaticEngine = true;
+			i++;
+			option = true;
+		}
+
+		if(strcmp("-D", argv[i+1])==0){
+			serverMode = true;
+			option = true;
+		}
+
+		if(strcmp("-j", argv[i+1])==0){
+			char *end = NULL;
+			if(i+2 < argc)
+				loadingThreads = strtol(argv[i+2], &end, 10);
+			if(end == NULL || end == argv[i+2] || *end != '\0' || loadingThreads < 1){
+				fprintf(stderr, "-j needs a positive number of threads\n");
+				exit(EXIT_FAILURE);
+			}
+			i++;
+			option = true;
+		}
+
 		if(!option){
-			graphs[numberGraphs++] = getGraphFromFile(argv[i+1]); 
+			fileNames[numberGraphs++] = argv[i+1]; 
 		}
 	}
-	
+	for(int i=1; i<argc; i++)
+	{
+		if(strcmp("-R", argv[i]) == 0)
+			i++;
+		else
+			arguments[numArguments++] = argv[i];
+	}
+	if(numEngines > 0)
+	{
+		if(serverMode || options.writeDotFile){
+			fprintf(stderr, "-R cannot be used with %s\n", serverMode ? "-D" : "-f (the engines would write the same files)");
+			exit(EXIT_FAILURE);
+		}
+		Z3_del_context(context);
+		return racePortfolio(numArguments, arguments, engines, numEngines, printStats, answerStatus);
+	}
+	if(loadingThreads == 0)
+		loadingThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	setSolverTimeout(options.solverTimeout);
+	setSolverDeadline(options.timeLimit);
+	if(solverKind != NULL && !setSolverKind(context, solverKind)){
+		fprintf(stderr, "Unknown kind of solver %s (default, simple, or tactics separated by commas)\n", solverKind);
+		exit(EXIT_FAILURE);
+	}
+	for(int i=0; i<numSolverParams; i++){
+		if(!addSolverParam(context, solverParams[i])){
+			fprintf(stderr, "The %s solver has no parameter %s (expected NAME=VALUE with a value of the type of NAME)\n", getSolverKind(), solverParams[i]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if((options.lazySimplicity || options.seedPhases) && strcmp(getCurrentPathEncoding()->name, "onehot") != 0){
+		fprintf(stderr, "%s only works with the onehot encoding\n", options.lazySimplicity ? "-l" : "-P");
+		exit(EXIT_FAILURE);
+	}
+
+	if(serverMode)
+	{
+		serve(context, options, printStats, loadingThreads, fileNames, numberGraphs);
+		free(options.lengths);
+		Z3_del_context(context);
+		return EXIT_SUCCESS;
+	}
+
+	getGraphsFromFiles(fileNames, numberGraphs, loadingThreads, graphs);
+	ReducedGraph reduced[numberGraphs];
+	for(int i=0; i<numberGraphs; i++)
+		reduced[i] = simplifyGraph(graphs[i]);
+	Query query;
+	query.graphs = graphs;
+	query.reduced = reduced;
+	query.numGraphs = numberGraphs;
+	query.caches = NULL;
+	query.lengths = NULL;
+	QueryStatistics statistics;
+	memset(&statistics, 0, sizeof(QueryStatistics));
+
+	if(options.cacheDirectory != NULL)
+	{
+		query.caches = (GraphCache *)malloc(numberGraphs*sizeof(GraphCache));
+		for(int i=0; i<numberGraphs; i++)
+			query.caches[i] = loadGraphCache(options.cacheDirectory, graphs[i]);
+	}
+
 	if(VERBOSE)
 	{
 		for(int i=0; i<numberGraphs; i++)
+		{
 			printGraph(graphs[i]);
+			printf("reduced to %d nodes and %d edges.\n", orderG(reduced[i].graph), sizeG(reduced[i].graph));
+		}
 		printf("\n");
 	}
-	if(TEST_SEPARATLY_BY_DEEPTH)
-		findPath(context, graphs, numberGraphs);
-	else
+	if(options.automaticEngine)
+		options = selectQueryEngine(options, query, VERBOSE, &statistics);
+	if(options.dynamicNodes > 0 && (options.separately || !(options.longest || options.shortest || options.lengths != NULL)))
+		query.lengths = computeDynamicLengths(reduced, numberGraphs, options.dynamicNodes, &statistics.dynamicGraphs);
+	Z3_lbool answer = answerQuery(context, options, query, &statistics);
+
+	if(printStats)
 	{
-		Z3_ast fullFormula = graphsToFullFormula(context, graphs, numberGraphs);	
-		if(isFormulaSat(context, fullFormula))
+		bool shared = !options.separately && (options.sharedFormula || options.longest || options.shortest || options.lengths != NULL);
+		printf("encoding: %s%s\n", shared ? "shared" : getCurrentPathEncoding()->name, (options.lazySimplicity && !shared) ? " (lazy simplicity)" : "");
+		printf("solver: %s", getSolverKind());
+		for(int i=0; i<numSolverParams; i++)
+			printf(" %s", solverParams[i]);
+		printf("\n");
+		Graph *reducedGraphs = getReducedGraphs(reduced, numberGraphs);
+		int low, high;
+		if(commonLengthBounds(reducedGraphs, numberGraphs, &low, &high))
+			printf("length window: %d to %d\n", low, high);
+		else
+			printf("length window: empty\n");
+		int maxLength, numPossible = 0;
+		bool *possible = possibleCommonLengths(reducedGraphs, numberGraphs, &maxLength);
+		for(int k=0; k<=maxLength; k++)
+			numPossible += possible[k];
+		printf("possible lengths (window and periods): %d\n", numPossible);
+		free(possible);
+		free(reducedGraphs);
+		printf("solver calls: %u\n", getNumSolverCalls());
+		if(options.searchBudget > 0)
+			printf("lengths found by search: %u\n", statistics.foundBySearch);
+		if(options.cacheDirectory != NULL)
+			printf("lengths decided by the cache: %u\n", statistics.foundInCache);
+		if(options.dynamicNodes > 0)
+			printf("graphs whose lengths were computed by dynamic programming: %u\n", statistics.dynamicGraphs);
+		if(options.solverTimeout > 0 || options.timeLimit > 0)
+			printf("lengths left undecided: %u\n", statistics.unresolved);
+		if(options.automaticEngine)
 		{
-			printf("OUI\n");
+			printf("features: %d nodes, %d edges, density %.3f, %.2f successors per node, largest component of %d nodes, %d lengths from %d to %d, %.0f variables, %.3g nodes to search, %.3g sets of nodes\n",
+				statistics.features.numNodes, statistics.features.numEdges, statistics.features.density, statistics.features.branching, statistics.features.largestComponent, statistics.features.numLengths, statistics.features.minLength, statistics.features.maxLength, statistics.features.variables, statistics.features.expansions, statistics.features.subsets);
+			printf("engine: %s (estimated:", getEngineName(statistics.engine));
+			for(int engine=0; engine<NUM_ENGINE_KINDS; engine++)
+				printf(" %s %.3g s", getEngineName((Engine)engine), estimateCost(options.costModel, statistics.features, (Engine)engine));
+			printf(")\n");
 		}
-		else
-			printf("NON\n");
-		if(PRINT_FORMULA)
-			printf("FULL FORMULA: %s\n", Z3_ast_to_string(context, fullFormula));
+		printf("time: %.3f s\n", (double)clock() / CLOCKS_PER_SEC);
 	}
 
+	for(int i=0; i<numberGraphs && query.caches != NULL; i++)
+	{
+		saveGraphCache(query.caches[i]);
+		deleteGraphCache(query.caches[i]);
+	}
+	free(query.caches);
+	deleteDynamicLengths(query.lengths, numberGraphs);
+	for(int i=0; i<numberGraphs; i++)
+	{
+		deleteReducedGraph(reduced[i]);
+		deleteGraph(graphs[i]);
+	}
+
+	free(options.lengths);
 	Z3_del_context(context);
-	return EXIT_SUCCESS;
+	if(!answerStatus)
+		return EXIT_SUCCESS;
+	if(answer == Z3_L_TRUE)
+		return EXIT_FOUND;
+	return answer == Z3_L_FALSE ? EXIT_NOT_FOUND : EXIT_UNDECIDED;
 }
 
 void usage(){
@@ -135,57 +465,78 @@ void usage(){
 	printf("-s	tests separatly all formulas by depth\n");
 	printf("-d	only if -s is present. Explore the length by decreasing order\n");
 	printf("-a	only if -s is present. Computes a result for every length\n");
-	printf("-t	displays the path found on the terminal\n");
-	printf("-f	write the result with color in a dot file\n");
+	printf("-e NAME	encodes the paths with the encoding NAME, among:\n");
+	for(int i=0; i<numPathEncodings(); i++)
+		printf("	%s: %s\n", getPathEncoding(i)->name, getPathEncoding(i)->description);
+	printf("-S	displays statistics at the end (encoding, number of calls to the solver, time)\n");
+	printf("-x	the exit status tells the answer: %d if a common length is found, %d if there is none (among the lengths asked), %d if it is\n", EXIT_FOUND, EXIT_NOT_FOUND, EXIT_UNDECIDED);
+	printf("	undecided by the solver, and another one (such as %d) on an error (without -x, %d unless there is an error; with -D, always %d)\n", EXIT_FAILURE, EXIT_SUCCESS, EXIT_SUCCESS);
+	printf("-M	without -s, finds the longest common length by a dichotomy in a single solver, instead of testing lengths one by one\n");
+	printf("-m	without -s, finds the shortest common length by a dichotomy in a single solver\n");
+	printf("-u	without -s, solves a single formula for all lengths instead of one formula per length (finds any common length, not the smallest)\n");
+	printf("-l	adds the constraints making paths simple only for the nodes repeated in the walks found (onehot encoding, with -s or alone)\n");
+	printf("-H N	with -s or alone, looks for the paths of each length by a depth-first search expanding at most N nodes per graph before calling the solver\n");
+	printf("-b	the search of -H (or of -A) meets in the middle: the halves of the paths from the target are kept, and joined to the ones from the source\n");
+	printf("-p N	the search of -H (or of -A) shares the branches of each graph between N threads, which steal them from each other\n");
+	printf("-B N	with -s or alone, computes the lengths of each graph of at most N nodes once simplified (up to %d) by dynamic programming\n", MAX_DYNAMIC_NODES);
+	printf("	over the sets of nodes visited, instead of solving it (a graph needing too many states is solved as without -B)\n");
+	printf("-P	with -s, the solver starts from the paths partially found by -H or found for the previous length (onehot encoding)\n");
+	printf("-r SET	only looks for the lengths of SET (such as 3,5,10-20): without -s, a single formula is solved for all of them\n");
+	printf("-C DIR	with -s or alone, keeps in DIR the lengths proven possible or impossible for each graph, and solves the graphs one by one\n");
+	printf("-T MS	gives at most MS milliseconds to each check of the solver: with -s, the lengths undecided are tried again with more time, then reported\n");
+	printf("-L MS	stops calling the solver MS milliseconds after the start (of each query with -D), the lengths not decided being reported as unknown\n");
+	printf("-k KIND	solves with the general solver of Z3 (default), a solver without preprocessing (simple), or the tactics given,\n");
+	printf("	separated by commas, applied one after the other (such as simplify,tseitin-cnf,sat: only for boolean encodings)\n");
+	printf("-K P=V	gives the value V to the parameter P of the solver (such as random_seed=3, restart=luby or threads=4), may be repeated\n");
+	printf("-R OPTS	races an engine running with the options of the string OPTS added (such as \"-e log -k simple\"), and displays the first definitive\n");
+	printf("	answer, stopping the other engines: each -R adds an engine (-R \"\" for the options given alone)\n");
+	printf("-A	chooses for each query the engine deciding the lengths (solver, search without budget or dynamic programming) with a cost model estimated from the graphs\n");
+	printf("-c FILE	same as -A with the cost model of FILE, with lines \"NAME SECONDS\" where NAME is solver_per_variable, solver_per_length,\n");
+	printf("	search_per_node, search_exponent, search_per_length, dynamic_per_state or dynamic_exponent (calibrated from the features\n");
+	printf("	and times displayed with -A -S)\n");
+	printf("-D	server mode: answers the queries \"first FILE...\", \"all FILE...\" or \"witness FILE...\" read on the standard input, each answer ending with END,\n");
+	printf("	keeping the graphs (the files given are loaded at once) and the context of the solver between the queries, a new solver being built for each check\n");
+	printf("-j N	reads the files with N threads (one per processor by default)\n");
+	printf("-t	displays the path found on the terminal (without -s, after OUI: without -t nor -f, only OUI or NON is displayed)\n");
+	printf("-f	write the result with color in a dot file (in the folder 'sol' unless -o is present), with or without -s\n");
+	printf("-o NAME	writes the dot files in \"NAME-lLENGTH.dot\" (on the terminal if NAME is -)\n");
 } 
 
-void findPath( Z3_context ctx, Graph *graphs,unsigned int numGraphs)
+bool *parseLengths(char *spec, int *numLengths)
 {
-	int min_vertices = orderG(graphs[0]);
-	
-	for(int i=1; i<numGraphs; i++)
+	/* first pass for the greatest length, second one to mark the lengths */
+	bool *lengths = NULL;
+	*numLengths = 0;
+	for(int pass=0; pass<2; pass++)
 	{
-		if(orderG(graphs[i]) < min_vertices)
-			min_vertices = orderG(graphs[i]);	
-	}
-
-	Z3_ast formula;
-	Z3_ast tabFormula[min_vertices];
-
-	int k=0, step = 1;
-	if(DECREASING_ORDER)
-	{
-		k=min_vertices-1;
-		step = -1;
-	}
-	int count = 0;
-	while(count <= min_vertices - 1)
-	{
-		tabFormula[k] = graphsToPathFormula(ctx, graphs, numGraphs, k);
-		if(isFormulaSat(ctx, tabFormula[k]) == Z3_L_TRUE)
+		char *current = spec;
+		while(true)
 		{
-			printf("There is a simple valide path of length %d in all graphs.\n", k);
-			if(PRINT_PATH){
-				Z3_model model = getModelFromSatFormula(ctx, tabFormula[k]);
-				printPathsFromModel(ctx, model, graphs, numGraphs, k);	
-			}
-			if(WRITE_PATH_IN_DOT_FILE){
-				Z3_model model = getModelFromSatFormula(ctx, tabFormula[k]);
-				char name[15];
-				sprintf(name, "result-l%d.dot%c", k, '\0');
-				createDotFromModel(ctx, model, graphs, numGraphs, k, name); 
-			}
-			if(PRINT_FORMULA)
-				printf("FORMULA FOR PATH OF LENGHT %d : %s\n", k, Z3_ast_to_string(ctx, tabFormula[k]));
-			if(!TEST_ALL)
+			char *end;
+			long low = strtol(current, &end, 10), high = low;
+			if(end != current && *end == '-')
+			{
+				current = end+1;
+				high = strtol(current, &end, 10);
+			}
+			if(end == current || low < 0 || high < low || (*end != ',' && *end != '\0'))
+			{
+				fprintf(stderr, "Malformed set of lengths %s (expected lengths or ranges MIN-MAX separated by commas)\n", spec);
+				exit(EXIT_FAILURE);
+			}
+			for(long k=low; k<=high; k++)
+			{
+				if(pass == 0 && k >= *numLengths)
+					*numLengths = k+1;
+				if(pass == 1)
+					lengths[k] = true;
+			}
+			if(*end == '\0')
 				break;
+			current = end+1;
 		}
-		else if(isFormulaSat(ctx, tabFormula[k]) == Z3_L_FALSE)
-		{
-			if(TEST_SEPARATLY_BY_DEEPTH || TEST_ALL)
-				printf("no simple valide path of length %d.\n", k);
-		}
-		k += step;
-		count++;
+		if(pass == 0)
+			lengths = (bool *)calloc(*numLengths, sizeof(bool));
 	}
+	return lengths;
 }